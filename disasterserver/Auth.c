@@ -11,26 +11,27 @@ const uint32_t authTypes[] = { authTypeOne, authTypeTwo, authTypeThree };
 
 bool auth_create_ticket(PeerData* peer, Packet* packet)
 {
-	peer->auth.one = (uint8_t) rand();
-	peer->auth.two = (uint8_t) rand() % 31;
-	peer->auth.type = rand() & ~authTypesAll;
+	Rng* rng = &peer->server->auth_rng;
+	peer->auth.one = (uint8_t) rng_next(rng);
+	peer->auth.two = (uint8_t) rng_range(rng, 31);
+	peer->auth.type = rng_next(rng) & ~authTypesAll;
 	// Red herrings? Nah, we have Red Rope(TM)
 	// All values here are complete bogus btw
 	PacketWrite(packet, packet_write16, 0);
 	PacketWrite(packet, packet_write16, 1);
 	PacketWrite(packet, packet_write8, peer->auth.one);
-	PacketWrite(packet, packet_write8, (uint8_t) rand() % 2);
+	PacketWrite(packet, packet_write8, (uint8_t) rng_range(rng, 2));
 	PacketWrite(packet, packet_write8, peer->auth.two);
 	const char balls[] = { 0xff, 0x1c, 0x22, 0x00, 0x14, 0x80 };
 	for (int i = 0; i < 3; i++)
 	{
-		PacketWrite(packet, packet_write8, balls[rand() % sizeof(balls)]);
+		PacketWrite(packet, packet_write8, balls[rng_range(rng, sizeof(balls))]);
 	}
 	PacketWrite(packet, packet_write32, peer->auth.type);
 	return true;
 }
 
-bool auth_verify_ticket(PeerData* peer, Packet* packet)
+bool auth_verify_ticket(PeerData* peer, PacketView* packet)
 {
 	PacketRead(checkcum, packet, packet_read64, uint64_t);
 	PacketRead(checkcum2, packet, packet_read64, uint64_t);
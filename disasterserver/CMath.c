@@ -1,5 +1,15 @@
 #include <CMath.h>
 
+// Picked at compile time, x86-64 always has SSE2
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define CMATH_AVX2
+	#define CMATH_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define CMATH_SSE2
+#endif
+
 float lerp(float a, float b, float f)
 {
 	return a * (1.0f - f) + (b * f);
@@ -15,7 +25,63 @@ float vector2_dist(Vector2* a, Vector2* b)
 	return sqrtf(powf(b->x - a->x, 2) + powf(b->y - a->y, 2));
 }
 
+float vector2_dist_sq(const Vector2* a, const Vector2* b)
+{
+	float dx = b->x - a->x, dy = b->y - a->y;
+	return dx * dx + dy * dy;
+}
+
 Vector2 vector2_dir(Vector2* a, Vector2* b)
 {
 	return (Vector2) { sign(a->x - b->x), sign(a->y - b->y) };
 }
+
+uint64_t vector2_within(const Vector2* center, const float* xs, const float* ys, size_t count, float radius)
+{
+	uint64_t mask = 0;
+	size_t i = 0;
+	float r2 = radius * radius;
+
+	if (count > 64)
+		count = 64;
+
+	// Lanes do the same mul/add as the scalar tail, so results match bit for bit
+	// (CMath.c is built without FP contraction so the tail never becomes an FMA)
+#ifdef CMATH_AVX2
+	__m256 cx8 = _mm256_set1_ps(center->x);
+	__m256 cy8 = _mm256_set1_ps(center->y);
+	__m256 r28 = _mm256_set1_ps(r2);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), cx8);
+		__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), cy8);
+		__m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+		mask |= (uint64_t)_mm256_movemask_ps(_mm256_cmp_ps(d2, r28, _CMP_LE_OQ)) << i;
+	}
+#endif
+
+#ifdef CMATH_SSE2
+	__m128 cx4 = _mm_set1_ps(center->x);
+	__m128 cy4 = _mm_set1_ps(center->y);
+	__m128 r24 = _mm_set1_ps(r2);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), cx4);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), cy4);
+		__m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		mask |= (uint64_t)_mm_movemask_ps(_mm_cmple_ps(d2, r24)) << i;
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		float dx = xs[i] - center->x;
+		float dy = ys[i] - center->y;
+		if (dx * dx + dy * dy <= r2)
+			mask |= (uint64_t)1 << i;
+	}
+
+	return mask;
+}
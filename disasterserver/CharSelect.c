@@ -52,7 +52,7 @@ bool charselect_choose_exe(Server *server, uint16_t *id)
 	if (weight == 0)
 		weight++;
 
-	uint32_t rnd = rand() % weight;
+	uint32_t rnd = rng_range(&server->rng, weight);
 	for (size_t i = 0; i < server->peers.capacity; i++)
 	{
 		PeerData *peer = (PeerData *)server->peers.ptr[i];
@@ -72,7 +72,7 @@ bool charselect_choose_exe(Server *server, uint16_t *id)
 		{
 			Info("%s (id %d, c %d) is exe!", peer->nickname.value, peer->id, peer->exe_chance);
 
-			peer->exe_chance = 1 + rand() % 1;
+			peer->exe_chance = 1 + rng_range(&server->rng, 1);
 			*id = peer->id;
 
 			return true;
@@ -85,7 +85,7 @@ bool charselect_choose_exe(Server *server, uint16_t *id)
 	return false;
 }
 
-bool charselect_state_handle(PeerData *v, Packet *packet)
+bool charselect_state_handle(PeerData *v, PacketView *packet)
 {
 	// Read header
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
@@ -117,7 +117,7 @@ bool charselect_state_handle(PeerData *v, Packet *packet)
 		PacketCreate(&pack, SERVER_LOBBY_CHARACTER_CHANGE);
 		PacketWrite(&pack, packet_write16, v->id);
 		PacketWrite(&pack, packet_write8, id);
-		server_broadcast(v->server, &pack, true);
+		server_roster_delta(v->server, v, ROSTER_CHANGE, &pack, 0);
 
 		const char *exes[] = {
 			"Classic Exe",
@@ -161,7 +161,7 @@ bool charselect_state_handle(PeerData *v, Packet *packet)
 			PacketCreate(&pack, SERVER_LOBBY_CHARACTER_CHANGE);
 			PacketWrite(&pack, packet_write16, v->id);
 			PacketWrite(&pack, packet_write8, id + 1);
-			server_broadcast(v->server, &pack, true);
+			server_roster_delta(v->server, v, ROSTER_CHANGE, &pack, 0);
 		}
 
 		const char *survs[] = {
@@ -186,7 +186,7 @@ bool charselect_state_handle(PeerData *v, Packet *packet)
 
 		Info("%s " LOG_RST "(id %d): %s", v->nickname.value, v->id, msg.value);
 		if (!server_cmd_handle(v->server, server_cmd_parse(&msg), v, &msg))
-			server_broadcast_ex(v->server, packet, true, v->id);
+			server_relay(v->server, packet, true, v->id);
 
 		break;
 	}
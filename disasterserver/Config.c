@@ -1,4 +1,5 @@
 #include <Config.h>
+#include <Persist.h>
 #include <Log.h>
 #include <cJSON.h>
 #include <stdio.h>
@@ -26,6 +27,7 @@ SERVER_API Config g_config =
 	.ping_limit = 250,
 #endif
 
+	.heartbeat_interval = 100,
 	.log_debug = false,
 	.log_file = false,
 	.map_list = { true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true },
@@ -37,10 +39,44 @@ SERVER_API Config g_config =
 cJSON*	g_bans = NULL;
 cJSON*	g_timeouts = NULL;
 cJSON*	g_ops = NULL;
+Store	g_banStore;
+Store	g_timeoutStore;
+Store	g_opStore;
 Mutex	g_banMut;
 Mutex	g_timeoutMut;
 Mutex	g_opMut;
 
+/* Binary index over the IP and range keys of g_banStore, guarded by g_banMut */
+static IpTrie ban_trie;
+
+static void ban_index(Store* store, const char* key, bool present)
+{
+	(void)store;
+
+	// UDIDs don't parse, anything that does is an address or a range
+	IpAddr addr;
+	uint8_t prefix;
+	if (!ip_parse(key, &addr, &prefix))
+		return;
+
+	if (present)
+		ip_trie_insert(&ban_trie, &addr, prefix);
+	else
+		ip_trie_remove(&ban_trie, &addr, prefix);
+}
+
+/* Stores addresses and ranges in canonical form so revokes find them again */
+static const char* ban_key(const char* ip, char* out, size_t size)
+{
+	IpAddr addr;
+	uint8_t prefix;
+	if (!ip_parse(ip, &addr, &prefix))
+		return ip;
+
+	ip_format(&addr, prefix, out, size);
+	return out;
+}
+
 bool write_default(const char* filename, const char* default_str)
 {
 	FILE* file = fopen(filename, "r");
@@ -151,6 +187,14 @@ bool config_init(void)
 	g_config.port =			(int32_t)cJSON_GetNumberValue(cJSON_GetObjectItemCaseSensitive(json, "port"));
 	g_config.server_count = (int32_t)cJSON_GetNumberValue(cJSON_GetObjectItemCaseSensitive(json, "server_count"));
 	g_config.ping_limit =	(int32_t)cJSON_GetNumberValue(cJSON_GetObjectItemCaseSensitive(json, "ping_limit"));
+	cJSON* heartbeat = cJSON_GetObjectItemCaseSensitive(json, "heartbeat_interval");
+	if (cJSON_IsNumber(heartbeat))
+		g_config.heartbeat_interval = (int32_t)cJSON_GetNumberValue(heartbeat);
+
+	cJSON* rng_seed = cJSON_GetObjectItemCaseSensitive(json, "rng_seed");
+	if (cJSON_IsNumber(rng_seed))
+		g_config.rng_seed = (uint32_t)cJSON_GetNumberValue(rng_seed);
+
 	g_config.log_file =		cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(json, "log_file"));
 	g_config.log_debug =	cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(json, "log_debug"));
 	g_config.anticheat =	cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(json, "anticheat"));
@@ -164,9 +208,23 @@ init_balls:
 	MutexCreate(g_banMut);
 	MutexCreate(g_opMut);
 
-	RAssert(collection_init(&g_timeouts,	TIMEOUTS_FILE,	"{}"));
-	RAssert(collection_init(&g_bans,		BANS_FILE,		"{}"));
-	RAssert(collection_init(&g_ops,		OPERATORS_FILE, "{ \"127.0.0.1\": \"Host (127.0.0.1)\" }"));
+	RAssert(store_init(&g_timeoutStore,	TIMEOUTS_FILE,	TIMEOUTS_JOURNAL,	"{}", true, &g_timeoutMut));
+	RAssert(store_init(&g_banStore,		BANS_FILE,		BANS_JOURNAL,		"{}", false, &g_banMut));
+	RAssert(store_init(&g_opStore,		OPERATORS_FILE, OPERATORS_JOURNAL,	"{ \"127.0.0.1\": \"Host (127.0.0.1)\" }", false, &g_opMut));
+
+	RAssert(ip_trie_init(&ban_trie));
+	for (cJSON* item = g_banStore.root->child; item; item = item->next)
+		ban_index(&g_banStore, item->string, true);
+
+	g_banStore.hook = ban_index;
+	Debug("Ban index holds %d addresses and ranges", (int)ban_trie.prefixes);
+
+	Store* stores[] = { &g_timeoutStore, &g_banStore, &g_opStore };
+	RAssert(persist_init(stores, 3));
+
+	g_timeouts = g_timeoutStore.root;
+	g_bans = g_banStore.root;
+	g_ops = g_opStore.root;
 
 	if (!g_config.anticheat)
 	{
@@ -184,6 +242,8 @@ SERVER_API bool config_save(void)
 	cJSON_AddItemToObject(json, "port", cJSON_CreateNumber(g_config.port));
 	cJSON_AddItemToObject(json, "server_count", cJSON_CreateNumber(g_config.server_count));
 	cJSON_AddItemToObject(json, "ping_limit", cJSON_CreateNumber(g_config.ping_limit));
+	cJSON_AddItemToObject(json, "heartbeat_interval", cJSON_CreateNumber(g_config.heartbeat_interval));
+	cJSON_AddItemToObject(json, "rng_seed", cJSON_CreateNumber(g_config.rng_seed));
 	cJSON_AddItemToObject(json, "log_file", cJSON_CreateBool(g_config.log_file));
 	cJSON_AddItemToObject(json, "log_debug", cJSON_CreateBool(g_config.log_debug));
 	cJSON_AddItemToObject(json, "anticheat", cJSON_CreateBool(g_config.anticheat));
@@ -198,27 +258,35 @@ SERVER_API bool config_save(void)
 bool ban_add(const char* nickname, const char* udid, const char* ip)
 {
 	bool res = true;
+	char key[IP_STRLEN];
 
 	MutexLock(g_banMut);
 	{
-		bool changed = false;
-		if (!cJSON_HasObjectItem(g_bans, ip))
-		{
-			cJSON* js = cJSON_CreateString(nickname);
-			cJSON_AddItemToObject(g_bans, ip, js);
-			changed = true;
-		}
+		res = store_put(&g_banStore, ban_key(ip, key, sizeof(key)), nickname, 0);
+		res = store_put(&g_banStore, udid, nickname, 0) && res;
+	}
+	MutexUnlock(g_banMut);
 
-		if (!cJSON_HasObjectItem(g_bans, udid))
-		{
-			cJSON* js = cJSON_CreateString(nickname);
-			cJSON_AddItemToObject(g_bans, udid, js);
-			changed = true;
-		}
+	return res;
+}
 
-		if (changed)
-			res = collection_save(BANS_FILE, g_bans);
-		
+bool ban_add_range(const char* nickname, const char* range)
+{
+	IpAddr addr;
+	uint8_t prefix;
+	if (!ip_parse(range, &addr, &prefix))
+	{
+		Warn("\"%s\" is not an address or range", range);
+		return false;
+	}
+
+	bool res = true;
+	char key[IP_STRLEN];
+	ip_format(&addr, prefix, key, sizeof(key));
+
+	MutexLock(g_banMut);
+	{
+		res = store_put(&g_banStore, key, nickname, 0);
 	}
 	MutexUnlock(g_banMut);
 
@@ -228,38 +296,25 @@ bool ban_add(const char* nickname, const char* udid, const char* ip)
 bool ban_revoke(const char* udid, const char* ip)
 {
 	bool res = false;
+	char key[IP_STRLEN];
 
 	MutexLock(g_banMut);
 	{
-		bool changed = false;
-
-		if (cJSON_HasObjectItem(g_bans, ip))
-		{
-			cJSON_DeleteItemFromObject(g_bans, ip);
-			changed = true;
-		}
-
-		if (cJSON_HasObjectItem(g_bans, udid))
-		{
-			cJSON_DeleteItemFromObject(g_bans, udid);
-			changed = true;
-		}
-
-		if(changed)
-			res = collection_save(BANS_FILE, g_bans);
+		res = store_remove(&g_banStore, ban_key(ip, key, sizeof(key)));
+		res = store_remove(&g_banStore, udid) || res;
 	}
 	MutexUnlock(g_banMut);
 
 	return res;
 }
 
-bool ban_check(const char* udid, const char* ip, bool* result)
+bool ban_check(const char* udid, const IpAddr* addr, bool* result)
 {
 	*result = false;
 
 	MutexLock(g_banMut);
 	{
-		if (cJSON_HasObjectItem(g_bans, udid) || cJSON_HasObjectItem(g_bans, ip))
+		if (ip_trie_match(&ban_trie, addr) || store_get(&g_banStore, udid))
 			*result = true;
 	}
 	MutexUnlock(g_banMut);
@@ -273,66 +328,8 @@ bool timeout_set(const char* nickname, const char* ip, const char* udid, uint64_
 
 	MutexLock(g_timeoutMut);
 	{
-		bool changed = false;
-
-		cJSON* obj = cJSON_GetObjectItem(g_timeouts, ip);
-		if (!obj)
-		{
-			cJSON* root = cJSON_CreateArray();
-
-			// store nickname
-			cJSON* js = cJSON_CreateString(nickname);
-			cJSON_AddItemToArray(root, js);
-
-			// store timestamp
-			js = cJSON_CreateNumber((double)timestamp);
-			cJSON_AddItemToArray(root, js);
-
-			cJSON_AddItemToObject(g_timeouts, ip, root);
-			changed = true;
-		}
-		else
-		{
-			cJSON* item = cJSON_GetArrayItem(obj, 1);
-			if (item)
-			{
-				cJSON_SetNumberValue(item, timestamp);
-				changed = true;
-			}
-			else
-				Warn("Missing timestamp in array");
-		}
-
-		obj = cJSON_GetObjectItem(g_timeouts, udid);
-		if (!obj)
-		{
-			cJSON* root = cJSON_CreateArray();
-
-			// store nickname
-			cJSON* js = cJSON_CreateString(nickname);
-			cJSON_AddItemToArray(root, js);
-
-			// store timestamp
-			js = cJSON_CreateNumber((double)timestamp);
-			cJSON_AddItemToArray(root, js);
-
-			cJSON_AddItemToObject(g_timeouts, udid, root);
-			changed = true;
-		}
-		else
-		{
-			cJSON* item = cJSON_GetArrayItem(obj, 1);
-			if (item)
-			{
-				cJSON_SetNumberValue(item, timestamp);
-				changed = true;
-			}
-			else
-				Warn("Missing timestamp in array");
-		}
-
-		if (changed)
-			res = collection_save(TIMEOUTS_FILE, g_timeouts);
+		res = store_put(&g_timeoutStore, ip, nickname, timestamp);
+		res = store_put(&g_timeoutStore, udid, nickname, timestamp) && res;
 	}
 	MutexUnlock(g_timeoutMut);
 
@@ -345,22 +342,8 @@ bool timeout_revoke(const char* udid, const char* ip)
 
 	MutexLock(g_timeoutMut);
 	{
-		bool changed = false;
-
-		if (cJSON_HasObjectItem(g_timeouts, ip))
-		{
-			cJSON_DeleteItemFromObject(g_timeouts, ip);
-			changed = true;
-		}
-
-		if (cJSON_HasObjectItem(g_timeouts, udid))
-		{
-			cJSON_DeleteItemFromObject(g_timeouts, udid);
-			changed = true;
-		}
-
-		if (changed)
-			res = collection_save(TIMEOUTS_FILE, g_timeouts);
+		res = store_remove(&g_timeoutStore, ip);
+		res = store_remove(&g_timeoutStore, udid) || res;
 	}
 	MutexUnlock(g_timeoutMut);
 
@@ -371,24 +354,17 @@ bool timeout_check(const char* udid, const char* ip, uint64_t* result)
 {
 	*result = 0;
 
-	MutexLock(g_opMut);
+	MutexLock(g_timeoutMut);
 	{
-		cJSON* obj = cJSON_GetObjectItem(g_timeouts, ip);
+		StoreEntry* entry = store_get(&g_timeoutStore, ip);
 
-		if(!obj)
-			obj = cJSON_GetObjectItem(g_timeouts, udid);
+		if (!entry)
+			entry = store_get(&g_timeoutStore, udid);
 
-		if (obj)
-		{
-			cJSON* timeout = cJSON_GetArrayItem(obj, 1);
-			
-			if (timeout)
-				*result = (uint64_t)cJSON_GetNumberValue(timeout);
-			else
-				Warn("Missing timestamp in array");
-		}
+		if (entry)
+			*result = entry->value;
 	}
-	MutexUnlock(g_opMut);
+	MutexUnlock(g_timeoutMut);
 
 	return true;
 }
@@ -399,13 +375,7 @@ bool op_add(const char* nickname, const char* ip)
 
 	MutexLock(g_opMut);
 	{
-		if (!cJSON_HasObjectItem(g_ops, ip))
-		{
-			cJSON* js = cJSON_CreateString(nickname);
-			cJSON_AddItemToObject(g_ops, ip, js);
-
-			res = collection_save(OPERATORS_FILE, g_ops);
-		}
+		res = store_put(&g_opStore, ip, nickname, 0);
 	}
 	MutexUnlock(g_opMut);
 
@@ -418,12 +388,7 @@ bool op_revoke(const char* ip)
 
 	MutexLock(g_opMut);
 	{
-		if (cJSON_HasObjectItem(g_ops, ip))
-		{
-			cJSON_DeleteItemFromObject(g_ops, ip);
-
-			res = collection_save(OPERATORS_FILE, g_ops);
-		}
+		res = store_remove(&g_opStore, ip);
 	}
 	MutexUnlock(g_opMut);
 
@@ -436,7 +401,7 @@ bool op_check(const char* ip, bool* result)
 
 	MutexLock(g_opMut);
 	{
-		if (cJSON_HasObjectItem(g_ops, ip))
+		if (store_get(&g_opStore, ip))
 			*result = true;
 	}
 	MutexUnlock(g_opMut);
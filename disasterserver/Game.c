@@ -104,22 +104,32 @@ bool game_state_check(Server* server)
 	return true;
 }
 
+const char* g_entityTags[ET_COUNT] =
+{
+#define X(type, tag) tag,
+	ENTITY_TYPES(X)
+#undef X
+};
+
 bool game_init(int exe, int8_t map, Server* server)
 {
 	Debug("Attepting to enter ST_GAME...");
 	RAssert(server_ingame(server) > 1);
 
+	// With a fixed seed every match rolls the same, so it can be replayed
+	if (g_config.rng_seed)
+		rng_seed(&server->rng, (uint64_t)g_config.rng_seed + server->id);
+
 	server->state = ST_GAME;
 	server->game = (Game)
 	{
 		.map = map,
 		.exe = exe,
 		.bring_state = BS_NONE,
-		.bring_loc = (uint8_t)rand(),
+		.bring_loc = (uint8_t)rng_next(&server->rng),
 		.sudden_death = false,
 		.started = false,
 		.end = 0.0,
-		.entid = 0,
 		.time = TICKSPERSEC,
 		.elapsed = 0.0,
 		.start_timeout = 15.0 * TICKSPERSEC
@@ -129,8 +139,15 @@ bool game_init(int exe, int8_t map, Server* server)
 	time_start(&server->game.tails_last_proj);
 	memset(server->game.rings, 0, sizeof(server->game.rings));
 	memset(server->game.cooldowns, 0, sizeof(server->game.cooldowns));
+	memset(server->game.type_head, 0, sizeof(server->game.type_head));
+	memset(server->game.type_tail, 0, sizeof(server->game.type_tail));
+	memset(server->game.type_count, 0, sizeof(server->game.type_count));
 
-	if (!dylist_create(&server->game.entities, 3000))
+	if (!slotmap_create(&server->game.entities, 3000))
+		return false;
+
+	server->game.despawn = (uint16_t*)malloc(server->game.entities.capacity * sizeof(uint16_t));
+	if (!server->game.despawn)
 		return false;
 	Debug("Entity list created.");
 
@@ -163,37 +180,56 @@ bool game_init(int exe, int8_t map, Server* server)
 	PacketCreate(&pack, SERVER_LOBBY_GAME_START);
 	server_broadcast(server, &pack, true);
 
+	// Extended clients in queue get the whole roster at once, without themselves like on join
 	for (size_t i = 0; i < server->peers.capacity; i++)
 	{
 		PeerData* v = (PeerData*)server->peers.ptr[i];
 		if (!v)
 			continue;
 
-		if (v->in_game)
+		if (v->in_game || !v->ext_proto)
+			continue;
+
+		Packet roster;
+		RAssert(server_roster_snapshot(server, &roster, v->id));
+		RAssert(packet_send(v->peer, &roster, true));
+	}
+
+	// Everyone else gets one info packet per player, each built only once
+	for (size_t j = 0; j < server->peers.capacity; j++)
+	{
+		PeerData* er = (PeerData*)server->peers.ptr[j];
+		if (!er)
 			continue;
 
-		for (size_t j = 0; j < server->peers.capacity; j++)
+		bool built = false;
+		for (size_t i = 0; i < server->peers.capacity; i++)
 		{
-			PeerData* er = (PeerData*)server->peers.ptr[j];
-			if (!er)
+			PeerData* v = (PeerData*)server->peers.ptr[i];
+			if (!v)
 				continue;
 
-			if (er->id == v->id)
+			if (v->in_game || v->ext_proto || er->id == v->id)
 				continue;
 
-			PacketCreate(&pack, SERVER_WAITING_PLAYER_INFO);
-			PacketWrite(&pack, packet_write8, er->in_game);
-			PacketWrite(&pack, packet_write16, er->id);
-			PacketWrite(&pack, packet_writestr, er->nickname);
-
-			if (er->in_game)
+			if (!built)
 			{
-				PacketWrite(&pack, packet_write8, server->game.exe == er->id);
-				PacketWrite(&pack, packet_write8, server->game.exe == er->id ? er->exe_char : er->surv_char);
-			}
-			else
-			{
-				PacketWrite(&pack, packet_write8, er->lobby_icon);
+				PacketCreate(&pack, SERVER_WAITING_PLAYER_INFO);
+				PacketWrite(&pack, packet_write8, er->in_game);
+				PacketWrite(&pack, packet_write16, er->id);
+				PacketWrite(&pack, packet_writestr, er->nickname);
+
+				if (er->in_game)
+				{
+					PacketWrite(&pack, packet_write8, server->game.exe == er->id);
+					PacketWrite(&pack, packet_write8, server->game.exe == er->id ? er->exe_char : er->surv_char);
+				}
+				else
+				{
+					PacketWrite(&pack, packet_write8, er->lobby_icon);
+				}
+
+				built = true;
 			}
 
 			RAssert(packet_send(v->peer, &pack, true));
@@ -210,26 +246,12 @@ bool game_uninit(Server* server, bool show_results)
 		return results_init(server);
 	else
 	{
-		for (size_t i = 0; i < server->game.entities.capacity; i++)
-		{
-			Entity* entity = (Entity*)server->game.entities.ptr[i];
-			if (!entity)
-				continue;
-
-			free(entity);
-		}
-		dylist_free(&server->game.entities);
-
-		// Clean up after game
-		for (size_t i = 0; i < server->game.left.capacity; i++)
-		{
-			PeerData* data = (PeerData*)server->game.left.ptr[i];
-			if (!data)
-				continue;
-
-			free(data);
-		}
+		// Clean up after game, entities and left players all live in the pool
+		slotmap_free(&server->game.entities);
 		dylist_free(&server->game.left);
+		free(server->game.despawn);
+		player_grid_free(&server->game.players);
+		pool_reset(&server->game.pool);
 
 		return lobby_init(server);
 	}
@@ -237,21 +259,42 @@ bool game_uninit(Server* server, bool show_results)
 
 bool game_spawn(Server* server, Entity* entity, size_t len, Entity** out)
 {
-	entity->id = ++server->game.entid;
-	Debug("Allocated entity \"%s\" (id %d, size %d)", entity->tag, entity->id, len);
-	
-	Entity* ent = (Entity*)malloc(len);
+	Entity* ent = (Entity*)pool_alloc(&server->game.pool, (uint8_t)entity->etype, len);
 	if(!ent)
 		return false;
-	 
+
 	memcpy(ent, entity, len);
+	ent->id = slotmap_insert(&server->game.entities, ent);
+	if (!ent->id)
+	{
+		game_free(server, ent);
+		return false;
+	}
+
+	entity->id = ent->id;
+	snprintf(ent->tag, sizeof(ent->tag), "%s", g_entityTags[ent->etype]);
+	Debug("Allocated entity \"%s\" (id %d, size %d)", ent->tag, ent->id, len);
+
 	if (ent->init && !ent->init(server, ent))
 	{
-		free(ent);
+		slotmap_remove(&server->game.entities, ent->id);
+		game_free(server, ent);
 		return false;
 	}
-	
-	dylist_push(&server->game.entities, ent);
+
+	// Link at the tail of its type list
+	Game* game = &server->game;
+	ent->type_prev = game->type_tail[ent->etype];
+	ent->type_next = NULL;
+
+	if (ent->type_prev)
+		ent->type_prev->type_next = ent;
+	else
+		game->type_head[ent->etype] = ent;
+
+	game->type_tail[ent->etype] = ent;
+	game->type_count[ent->etype]++;
+
 	if (out)
 		*out = ent;
 	return true;
@@ -259,61 +302,69 @@ bool game_spawn(Server* server, Entity* entity, size_t len, Entity** out)
 
 bool game_despawn(Server* server, Entity** out, uint16_t id)
 {
-	bool res = true;
-	Entity* tar = NULL;
-
-	for (size_t i = 0; i < server->game.entities.capacity; i++)
+	Entity* tar = (Entity*)slotmap_get(&server->game.entities, id);
+	if (!tar)
 	{
-		Entity* entity = (Entity*)server->game.entities.ptr[i];
-		if (!entity)
-			continue;
-
-		if (entity->id == id)
-		{
-			if (entity->uninit && !entity->uninit(server, entity))
-				Warn("uninit failed for entity %d", entity->id);
+		if (out)
+			*out = NULL;
 
-			Debug("Deallocated entity \"%s\" (id %d)", entity->tag, entity->id);
-			tar = entity;
-			break;
-		}
+		Warn("Failed to find entity %d", id);
+		return false;
 	}
 
-	res = dylist_remove(&server->game.entities, tar);
-	if (res && !out)
-		free(tar);
-	else if (out)
+	if (tar->uninit && !tar->uninit(server, tar))
+		Warn("uninit failed for entity %d", tar->id);
+
+	Debug("Deallocated entity \"%s\" (id %d)", tar->tag, tar->id);
+	slotmap_remove(&server->game.entities, id);
+
+	Game* game = &server->game;
+	if (tar->type_prev)
+		tar->type_prev->type_next = tar->type_next;
+	else
+		game->type_head[tar->etype] = tar->type_next;
+
+	if (tar->type_next)
+		tar->type_next->type_prev = tar->type_prev;
+	else
+		game->type_tail[tar->etype] = tar->type_prev;
+
+	game->type_count[tar->etype]--;
+
+	if (out)
 		*out = tar;
 	else
-		Warn("Failed to find entity %d", id);
+		game_free(server, tar);
 
-	return res;
+	return true;
 }
 
-int game_find(Server* server, Entity** out, char* tag, size_t count)
+void game_free(Server* server, Entity* entity)
 {
-	int i = 0;
+	pool_release(&server->game.pool, (uint8_t)entity->etype, entity);
+}
 
-	for (size_t it = 0; it < server->game.entities.capacity; it++)
+int game_find(Server* server, Entity** out, char* tag, size_t count)
+{
+	for (int type = 0; type < ET_COUNT; type++)
 	{
-		Entity* entity = (Entity*)server->game.entities.ptr[it];
-		if (!entity)
-			continue;
+		if (strcmp(g_entityTags[type], tag) == 0)
+			return game_find_type(server, out, (EntityType)type, count);
+	}
 
-		Debug("Search %s (id %d) vs %s", entity->tag, entity->id, tag);
-		if (strcmp(entity->tag, tag) == 0)
-		{
-			if (!out)
-				i++;
-			else
-				out[i++] = entity;
+	Warn("Unknown entity tag \"%s\"", tag);
+	return 0;
+}
 
-			if ((size_t)i >= count)
-				break;
-		}
-	}
+int game_find_type(Server* server, Entity** out, EntityType type, size_t count)
+{
+	if (!out)
+		return (int)(server->game.type_count[type] < count ? server->game.type_count[type] : count);
+
+	int i = 0;
+	for (Entity* entity = server->game.type_head[type]; entity && (size_t)i < count; entity = entity->type_next)
+		out[i++] = entity;
 
-	Debug("Search for \"%s\" found %d entities", tag, i);
 	return i;
 }
 
@@ -382,7 +433,7 @@ bool game_checkstart(Server* server)
 		PacketCreate(&pack, SERVER_GAME_PLAYERS_READY);
 		server_broadcast(server, &pack, true);
 
-		srand((unsigned int)time(NULL));
+		RAssert(player_grid_build(&server->game.players, server));
 		RAssert(g_mapList[server->game.map].cb.init(server));
 		Info(LOG_YLW "Game started! " LOG_RST "(Time %ds)", server->game.time_sec);
 
@@ -471,6 +522,8 @@ bool game_state_join(PeerData* v)
 
 bool game_state_left(PeerData* v)
 {
+	player_grid_remove(&v->server->game.players, v);
+
 	if (v->server->game.end > 0)
 		return true;
 
@@ -490,7 +543,7 @@ bool game_state_left(PeerData* v)
 		return game_checkstart(v->server);
 	}
 
-	PeerData* data = (PeerData*)malloc(sizeof(PeerData));
+	PeerData* data = (PeerData*)pool_alloc(&v->server->game.pool, POOL_CLASS_LEFT, sizeof(PeerData));
 	RAssert(data);
 	memcpy(data, v, sizeof(PeerData));
 
@@ -505,7 +558,7 @@ bool game_state_left(PeerData* v)
 	return true;
 }
 
-bool game_state_handletcp(PeerData* v, Packet* packet)
+bool game_state_handletcp(PeerData* v, PacketView* packet)
 {
 	// Read header
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
@@ -526,7 +579,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 		case CLIENT_RING_BROKE:
 		{
 			AssertOrDisconnect(v->server, v->in_game);
-			server_broadcast_ex(v->server, packet, true,  v->id);
+			server_relay(v->server, packet, true, v->id);
 			break;
 		}
 
@@ -534,7 +587,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 		{
 			AssertOrDisconnect(v->server, v->in_game);
 			AssertOrDisconnect(v->server, !g_config.anticheat || palette_player_validate(v, packet));
-			server_broadcast_ex(v->server, packet, true,  v->id);
+			server_relay(v->server, packet, true, v->id);
 			break;
 		}
 
@@ -558,7 +611,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 				return true;
 			}
 
-			server_broadcast_ex(v->server, packet, true, v->id);
+			server_relay(v->server, packet, true, v->id);
 			break;
 		}
 
@@ -595,7 +648,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 			v->plr.heal_rings = 0;
 			v->plr.stats.hp_restored++;
 
-			server_broadcast_ex(v->server, packet, true, v->id);
+			server_relay(v->server, packet, true, v->id);
 			break;
 		}
 
@@ -658,7 +711,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 		case CLIENT_PLAYER_HURT:
 		{
 			AssertOrDisconnect(v->server, v->in_game);
-			server_broadcast_ex(v->server, packet, true, v->id);
+			server_relay(v->server, packet, true, v->id);
 			break;
 		}
 
@@ -674,7 +727,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 			AssertOrDisconnect(v->server, v->in_game);
 			AssertOrDisconnect(v->server, v->id != v->server->game.exe);
 			AssertOrDisconnect(v->server, v->surv_char == CH_TAILS);
-			AssertOrDisconnect(v->server, game_find(v->server, NULL, "tproj", 10) <= 2);
+			AssertOrDisconnect(v->server, game_find_type(v->server, NULL, ET_TPROJECTILE, 10) <= 2);
 
 			int cooldown_id = v->plr.flags & PLAYER_DEMONIZED ? ETAILS_RECHARGE : TAILS_RECHARGE;
 			if(v->server->game.cooldowns[cooldown_id] > 0)
@@ -738,7 +791,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 			AssertOrDisconnect(v->server, v->in_game);
 
 			Entity* ents;
-			if (game_find(v->server, &ents, "tproj", 1))
+			if (game_find_type(v->server, &ents, ET_TPROJECTILE, 1))
 				game_despawn(v->server, NULL, ents->id);
 
 			break;
@@ -771,7 +824,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 				PacketWrite(&pack, packet_write8, ent->red);
 				PacketWrite(&pack, packet_write8, data->plr.rings > 0);
 
-				free(ent);
+				game_free(v->server, (Entity*)ent);
 				RAssert(packet_send(v->peer, &pack, true));
 			}
 			break;
@@ -810,7 +863,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 			if (red_ring)
 			{				
 				CreamRing* rings[128];
-				int cnt = game_find(v->server, (Entity**)rings, "cring", 128);
+				int cnt = game_find_type(v->server, (Entity**)rings, ET_CREAMRING, 128);
 				
 				for(int i = 0; i < cnt; i++)
 				{
@@ -869,7 +922,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 			PacketRead(eid, packet, packet_read16, uint16_t);
 			
 			Entity* ents[50];
-			int found = game_find(v->server, ents, "eggtrack", 50);
+			int found = game_find_type(v->server, ents, ET_EGGTRACKER, 50);
 
 			for (int i = 0; i < found; i++)
 			{
@@ -903,7 +956,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 			}
 
 			BRing* rings[128];
-			int cnt = game_find(v->server, (Entity**)rings, "bring", 128);
+			int cnt = game_find_type(v->server, (Entity**)rings, ET_BLACKRING, 128);
 			
 			Vector2 pos = { x, y };
 			for(int i = 0; i < cnt; i++)
@@ -964,7 +1017,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 			AssertOrDisconnect(v->server, v->in_game);
 			AssertOrDisconnect(v->server, v->id == v->server->game.exe);
 			AssertOrDisconnect(v->server, v->exe_char == EX_EXELLER);
-			AssertOrDisconnect(v->server, game_find(v->server, NULL, "exclone", 3) < 2);
+			AssertOrDisconnect(v->server, game_find_type(v->server, NULL, ET_EXELLERCLONE, 3) < 2);
 
 			PacketRead(x, packet, packet_read16, uint16_t);
 			PacketRead(y, packet, packet_read16, uint16_t);
@@ -995,7 +1048,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 					PacketWrite(&pack, packet_write16, (uint16_t)v->plr.pos.y);
 					PacketWrite(&pack, packet_write8, clone->dir);
 					RAssert(packet_send(v->peer, &pack, true));
-					free(clone);
+					game_free(v->server, (Entity*)clone);
 					break;
 				}
 
@@ -1005,7 +1058,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 				PacketWrite(&pack, packet_write16, clone->id);
 				server_broadcast(v->server, &pack, true);
 
-				free(clone);
+				game_free(v->server, (Entity*)clone);
 				v->plr.ex_teleport = 60;
 			}
 			break; 
@@ -1082,7 +1135,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 					v->plr.death_timer_sec = 30;
 
 					PacketCreate(&pack, SERVER_GAME_DEATHTIMER_TICK);
-					PacketWrite(&pack, packet_write8, exe && vector2_dist(&v->plr.pos, &exe->plr.pos) <= 240);
+					PacketWrite(&pack, packet_write8, exe && vector2_dist_sq(&v->plr.pos, &exe->plr.pos) <= 240 * 240);
 					PacketWrite(&pack, packet_write16, v->id);
 					PacketWrite(&pack, packet_write8, v->plr.death_timer_sec);
 					server_broadcast(v->server, &pack, true);
@@ -1211,7 +1264,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 
 			Info("%s " LOG_RST "(id %d): %s", v->nickname.value, v->id, msg.value);
 			if (!server_cmd_handle(v->server, server_cmd_parse(&msg), v, &msg))
-				server_broadcast_ex(v->server, packet, true, v->id);
+				server_relay(v->server, packet, true, v->id);
 
 			break;
 		}
@@ -1362,6 +1415,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 				}
 			}
 			
+			player_update_zone(v->server, v, new_pos);
 			v->plr.pos = new_pos;
 			v->plr.timeout = 0;
 
@@ -1420,18 +1474,7 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 				v->plr.state = state;
 				time_start(&v->plr.last_packet);
 
-				Packet pack;
-				PacketCreate(&pack, CLIENT_PLAYER_DATA);
-				PacketWrite(&pack, packet_write16, v->id);
-
-				RAssert(packet_seek(packet, 2));
-				while (packet->pos < packet->len)
-				{
-					PacketRead(i, packet, packet_read8, uint8_t);
-					PacketWrite(&pack, packet_write8, i);
-				}
-
-				server_broadcast_ex(v->server, &pack, false, v->id);
+				server_relay_from(v->server, packet, false, v->id);
 			}
 			break;
 		}
@@ -1456,29 +1499,26 @@ bool game_state_handletcp(PeerData* v, Packet* packet)
 
 bool game_entity_tick(Server* server)
 {
-	int32_t entits[100];
-	int entit = 0;
-
-	for(int i = 0; i < 100; i++)
-		entits[i] = -1;
+	Game* game = &server->game;
+	size_t count = 0;
 
-	for (size_t i = 0; i < server->game.entities.capacity; i++)
+	// All entities of a type run back to back through the same tick
+	for (int type = 0; type < ET_COUNT; type++)
 	{
-		Entity* ent = (Entity*)server->game.entities.ptr[i];
-		if (!ent)
+		Entity* ent = game->type_head[type];
+		if (!ent || !ent->tick)
 			continue;
 
-		if (ent->tick && !ent->tick(server, ent))
-			entits[entit++] = ent->id;
+		bool (*tick)(Server*, Entity*) = ent->tick;
+		for (; ent; ent = ent->type_next)
+		{
+			if (!tick(server, ent))
+				game->despawn[count++] = ent->id;
+		}
 	}
 
-	for (int i = 0; i < 100; i++)
-	{
-		if (entits[i] == -1)
-			break;
-
-		game_despawn(server, NULL, (uint16_t)entits[i]);
-	}
+	for (size_t i = 0; i < count; i++)
+		game_despawn(server, NULL, game->despawn[i]);
 
 	return true;
 }
@@ -1534,7 +1574,7 @@ bool game_player_tick(Server* server)
 			}
 		}
 
-		if((data->plr.flags & PLAYER_DEAD) && !(data->plr.flags & PLAYER_CANTREVIVE) && vector2_dist(&exe->plr.pos, &data->plr.pos) < 300)
+		if((data->plr.flags & PLAYER_DEAD) && !(data->plr.flags & PLAYER_CANTREVIVE) && vector2_dist_sq(&exe->plr.pos, &data->plr.pos) < 300 * 300)
 			exe_camp = true;
 
 		if (exe->id != data->id && !(data->plr.flags & PLAYER_DEAD) && !(data->plr.flags & PLAYER_DEMONIZED))
@@ -1542,7 +1582,7 @@ bool game_player_tick(Server* server)
 			// calc danger time
 			if (!(data->plr.flags & PLAYER_ESCAPED))
 			{
-				bool in_danger = exe && vector2_dist(&data->plr.pos, &exe->plr.pos) < 300;
+				bool in_danger = exe && vector2_dist_sq(&data->plr.pos, &exe->plr.pos) < 300 * 300;
 				if (in_danger)
 					data->plr.stats.danger_time += server->delta;
 				
@@ -1682,28 +1722,21 @@ bool game_player_tick(Server* server)
 			bool demonized_near = false;
 
 			// check if exe is nearby
-			for (size_t j = 0; j < server->peers.capacity; j++)
+			PeerData* near[PLAYERGRID_MAXQUERY];
+			size_t near_count = player_grid_radius(&server->game.players, data->plr.pos, 240, near, PLAYERGRID_MAXQUERY);
+			for (size_t j = 0; j < near_count; j++)
 			{
-				PeerData* check = (PeerData*)server->peers.ptr[j];
-				if (!check)
-					continue;
-
-				if(!check->in_game)
-					continue;
-
+				PeerData* check = near[j];
 				if (check->id != server->game.exe && !(check->plr.flags & PLAYER_DEMONIZED))
 					continue;
 
-				if (vector2_dist(&data->plr.pos, &check->plr.pos) <= 240)
+				if (check->plr.flags & PLAYER_DEMONIZED)
+					demonized_near = true;
+				else
 				{
-					if (check->plr.flags & PLAYER_DEMONIZED)
-						demonized_near = true;
-					else
-					{
-						demonized_near = false;
-						exe_near = true;
-						break;
-					}
+					demonized_near = false;
+					exe_near = true;
+					break;
 				}
 			}
 
@@ -1800,6 +1833,7 @@ bool game_state_tick(Server* server)
 			RAssert(game_end(server, ED_TIMEOVER, true));
 	}
 
+	RAssert(player_grid_build(&server->game.players, server));
 	RAssert(game_player_tick(server));
 	RAssert(game_entity_tick(server));
 	RAssert(g_mapList[server->game.map].cb.tick(server));
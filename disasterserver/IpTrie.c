@@ -0,0 +1,222 @@
+#include <IpTrie.h>
+#include <Log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <arpa/inet.h>
+#endif
+
+#define IPTRIE_MIN_CAPACITY 256
+
+static const uint8_t v4_mapped[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF };
+
+static inline int ip_bit(const IpAddr* addr, int i)
+{
+	return (addr->bytes[i / 8] >> (7 - i % 8)) & 1;
+}
+
+static void ip_mask(IpAddr* addr, uint8_t prefix)
+{
+	for (int i = prefix; i < IP_BITS; i++)
+		addr->bytes[i / 8] &= (uint8_t)~(0x80 >> (i % 8));
+}
+
+void ip_addr_v4(IpAddr* addr, uint32_t host)
+{
+	// ENet keeps the host in network order already
+	memcpy(addr->bytes, v4_mapped, 12);
+	memcpy(addr->bytes + 12, &host, 4);
+}
+
+bool ip_parse(const char* str, IpAddr* addr, uint8_t* prefix)
+{
+	char buf[IP_STRLEN];
+	if (snprintf(buf, sizeof(buf), "%s", str) >= (int)sizeof(buf))
+		return false;
+
+	int bits = -1;
+	char* slash = strchr(buf, '/');
+	if (slash)
+	{
+		char* end;
+		*slash = '\0';
+
+		long len = strtol(slash + 1, &end, 10);
+		if (end == slash + 1 || *end || len < 0 || len > IP_BITS)
+			return false;
+
+		bits = (int)len;
+	}
+
+	uint8_t v4[4];
+	if (inet_pton(AF_INET, buf, v4) == 1)
+	{
+		if (bits > 32)
+			return false;
+
+		memcpy(addr->bytes, v4_mapped, 12);
+		memcpy(addr->bytes + 12, v4, 4);
+		bits = bits < 0 ? IP_BITS : 96 + bits;
+	}
+	else if (inet_pton(AF_INET6, buf, addr->bytes) == 1)
+		bits = bits < 0 ? IP_BITS : bits;
+	else
+		return false;
+
+	// Keep ranges in canonical form, 10.0.0.7/8 is 10.0.0.0/8
+	ip_mask(addr, (uint8_t)bits);
+	*prefix = (uint8_t)bits;
+	return true;
+}
+
+void ip_format(const IpAddr* addr, uint8_t prefix, char* out, size_t size)
+{
+	char text[IP_STRLEN];
+	int shown = prefix;
+
+	if (prefix >= 96 && memcmp(addr->bytes, v4_mapped, 12) == 0)
+	{
+		inet_ntop(AF_INET, (void*)(addr->bytes + 12), text, sizeof(text));
+		shown -= 96;
+	}
+	else
+	{
+		inet_ntop(AF_INET6, (void*)addr->bytes, text, sizeof(text));
+	}
+
+	if (prefix < IP_BITS)
+		snprintf(out, size, "%s/%d", text, shown);
+	else
+		snprintf(out, size, "%s", text);
+}
+
+static uint32_t ip_trie_node(IpTrie* trie)
+{
+	uint32_t index = trie->free_list;
+	if (index)
+		trie->free_list = trie->nodes[index].child[0];
+	else
+	{
+		if (trie->count >= trie->capacity)
+		{
+			uint32_t capacity = trie->capacity * 2;
+			IpTrieNode* nodes = (IpTrieNode*)realloc(trie->nodes, capacity * sizeof(IpTrieNode));
+			if (!nodes)
+				return 0;
+
+			trie->nodes = nodes;
+			trie->capacity = capacity;
+		}
+
+		index = trie->count++;
+	}
+
+	memset(&trie->nodes[index], 0, sizeof(IpTrieNode));
+	return index;
+}
+
+bool ip_trie_init(IpTrie* trie)
+{
+	memset(trie, 0, sizeof(IpTrie));
+	trie->nodes = (IpTrieNode*)calloc(IPTRIE_MIN_CAPACITY, sizeof(IpTrieNode));
+	RAssert(trie->nodes);
+
+	// Node 0 is the root, which doubles as "no child"
+	trie->capacity = IPTRIE_MIN_CAPACITY;
+	trie->count = 1;
+	return true;
+}
+
+bool ip_trie_insert(IpTrie* trie, const IpAddr* addr, uint8_t prefix)
+{
+	uint32_t node = 0;
+	for (int i = 0; i < prefix; i++)
+	{
+		int bit = ip_bit(addr, i);
+		if (!trie->nodes[node].child[bit])
+		{
+			uint32_t next = ip_trie_node(trie);
+			RAssert(next);
+
+			trie->nodes[node].child[bit] = next;
+		}
+
+		node = trie->nodes[node].child[bit];
+	}
+
+	if (trie->nodes[node].refs++ == 0)
+		trie->prefixes++;
+
+	return true;
+}
+
+bool ip_trie_remove(IpTrie* trie, const IpAddr* addr, uint8_t prefix)
+{
+	uint32_t path[IP_BITS + 1];
+	uint32_t node = 0;
+
+	path[0] = 0;
+	for (int i = 0; i < prefix; i++)
+	{
+		node = trie->nodes[node].child[ip_bit(addr, i)];
+		if (!node)
+			return false;
+
+		path[i + 1] = node;
+	}
+
+	if (!trie->nodes[node].refs)
+		return false;
+
+	// Still stored under another spelling
+	if (--trie->nodes[node].refs > 0)
+		return true;
+
+	trie->prefixes--;
+
+	// Prune the branch back up to the last node something else still needs
+	for (int i = prefix; i > 0; i--)
+	{
+		IpTrieNode* cur = &trie->nodes[path[i]];
+		if (cur->refs || cur->child[0] || cur->child[1])
+			break;
+
+		trie->nodes[path[i - 1]].child[ip_bit(addr, i - 1)] = 0;
+		cur->child[0] = trie->free_list;
+		trie->free_list = path[i];
+	}
+
+	return true;
+}
+
+bool ip_trie_match(const IpTrie* trie, const IpAddr* addr)
+{
+	if (!trie->nodes)
+		return false;
+
+	// Any stored prefix on the way down covers the address
+	uint32_t node = 0;
+	for (int i = 0;; i++)
+	{
+		if (trie->nodes[node].refs)
+			return true;
+
+		if (i == IP_BITS)
+			return false;
+
+		node = trie->nodes[node].child[ip_bit(addr, i)];
+		if (!node)
+			return false;
+	}
+}
+
+void ip_trie_free(IpTrie* trie)
+{
+	free(trie->nodes);
+	memset(trie, 0, sizeof(IpTrie));
+}
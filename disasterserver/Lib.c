@@ -7,8 +7,14 @@
 #include <States.h>
 #include <DyList.h>
 #include <Config.h>
+#include <Zone.h>
+#include <MapData.h>
+#include <Persist.h>
+
+#define SHUTDOWN_WAIT	2000	/* ms to wait for lobby workers before the final store drain */
 
 ThreadVar		g_threadName;
+ThreadVar		g_packetArena;
 DyList			servers;
 bool 			running = 0;
 
@@ -65,6 +71,7 @@ bool disaster_init(void)
 	// Init global variables
 	ThreadVarCreate(g_threadName);
 	ThreadVarSet(g_threadName, "Main Thr");
+	ThreadVarCreate(g_packetArena);
 
 #ifdef SYS_ANDROID
 	log_hook(log_android);
@@ -79,6 +86,8 @@ bool disaster_init(void)
 
 	RAssert(config_init());
 	RAssert(log_init());
+	RAssert(map_data_init(MAPDATA_FILE));
+	RAssert(zone_grid_init());
 
 	RAssert(dylist_create(&servers, g_config.server_count));
 	for (int32_t i = 0; i < g_config.server_count; i++)
@@ -87,6 +96,13 @@ bool disaster_init(void)
 	return true;
 }
 
+static bool disaster_worker(Server* server)
+{
+	bool res = server_worker(server);
+	AtomicStore32(&server->stopped, 1);
+	return res;
+}
+
 int disaster_run(void)
 {
 	if (running)
@@ -102,7 +118,7 @@ int disaster_run(void)
 			continue;
 
 		Thread th;
-		ThreadSpawn(th, server_worker, server);
+		ThreadSpawn(th, disaster_worker, server);
 	}
 
 	// dont ask too many questions
@@ -120,6 +136,33 @@ void disaster_shutdown(void)
 		return;
 
 	running = false;
+
+	// Lobbies push store records (timeouts, bans) until their worker returns, stop them before the last drain
+	for (size_t i = 0; i < servers.capacity; i++)
+	{
+		Server* server = (Server*)servers.ptr[i];
+		if (server)
+			server->running = false;
+	}
+
+	// Bounded, a signal handled on a worker thread keeps that worker from ever returning
+	for (int waited = 0; waited < SHUTDOWN_WAIT; waited += 10)
+	{
+		bool busy = false;
+		for (size_t i = 0; i < servers.capacity; i++)
+		{
+			Server* server = (Server*)servers.ptr[i];
+			if (server && !AtomicLoad32(&server->stopped))
+				busy = true;
+		}
+
+		if (!busy)
+			break;
+
+		ThreadSleep(10);
+	}
+
+	persist_stop();
 	exit(0);
 }
 
@@ -174,6 +217,31 @@ bool disaster_server_ban(Server* server, uint16_t id)
 	return false;
 }
 
+bool disaster_server_ban_range(Server* server, uint16_t id, uint8_t prefix)
+{
+	// Bans the peer along with its IPv4 /prefix network
+	if (prefix > 32)
+		return false;
+
+	for (size_t i = 0; i < server->peers.capacity; i++)
+	{
+		PeerData* v = (PeerData*)server->peers.ptr[i];
+		if (!v)
+			continue;
+
+		if (v->id == id)
+		{
+			char range[IP_STRLEN];
+			ip_format(&v->addr, (uint8_t)(96 + prefix), range, sizeof(range));
+
+			server_disconnect(server, v->peer, DR_BANNEDBYHOST, NULL);
+			return ban_add(v->nickname.value, v->udid.value, v->ip.value) && ban_add_range(v->nickname.value, range);
+		}
+	}
+
+	return false;
+}
+
 bool disaster_server_op(Server* server, uint16_t id)
 {
 	for (size_t i = 0; i < server->peers.capacity; i++)
@@ -256,6 +324,11 @@ int disaster_server_peer_ingame(Server* server)
 	return server_ingame(server);
 }
 
+uint32_t disaster_server_backlog(Server* server)
+{
+	return server->net.backlog;
+}
+
 int8_t disaster_game_map(Server* server)
 {
 	return server->game.map;
@@ -107,7 +107,7 @@ bool lobby_check_countdown(Server* server)
 	return true;
 }
 
-bool lobby_state_handle(PeerData* v, Packet* packet)
+bool lobby_state_handle(PeerData* v, PacketView* packet)
 {
 	// sub-state machine
 	switch (v->server->state)
@@ -162,16 +162,8 @@ bool lobby_state_handle(PeerData* v, Packet* packet)
 			PacketCreate(&pack, SERVER_LOBBY_CORRECT);
 			RAssert(packet_send(v->peer, &pack, true));
 
-			char msg[100];
-			snprintf(msg, 100, "server " CLRCODE_RED "%d" CLRCODE_RST " of " CLRCODE_BLU "%d" CLRCODE_RST, v->server->id+1, g_config.server_count);
-
-			server_send_msg(v->server, v->peer, "-----------------------");
-			server_send_msg(v->server, v->peer, CLRCODE_RED "better/server~ v" STRINGIFY(BUILD_VERSION));
-			server_send_msg(v->server, v->peer, "build from " CLRCODE_PUR  __DATE__ " " CLRCODE_GRN  __TIME__ CLRCODE_RST);
-			server_send_msg(v->server, v->peer, msg);
-			server_send_msg(v->server, v->peer, "-----------------------");
-			server_send_msg(v->server, v->peer, CLRCODE_GRA "type .help for command list~");
-			server_send_msg(v->server, v->peer, g_config.motd);
+			static const CachedMsg welcome[] = { MSG_LINE, MSG_BANNER, MSG_BUILD, MSG_SERVER, MSG_LINE, MSG_HELP_HINT, MSG_MOTD };
+			server_send_cached(v->server, v->peer, welcome, sizeof(welcome) / sizeof(*welcome));
 
 			if (v->mod_tool)
 				server_send_msg(v->server, v->peer, CLRCODE_RED "your mod is disallowed on this server" CLRCODE_RST);
@@ -389,7 +381,7 @@ bool lobby_state_handle(PeerData* v, Packet* packet)
 
 			Info("%s " LOG_RST "(id %d): %s", v->nickname.value, v->id, msg.value);
 			if(!ignore)
-				server_broadcast_ex(v->server, packet, true, v->id);
+				server_relay(v->server, packet, true, v->id);
 			
 			break;
 		}
@@ -592,8 +584,6 @@ bool lobby_state_tick(Server* server)
 
 bool lobby_init(Server* server)
 {
-	srand((unsigned int)time(NULL));
-
 	Debug("Attepting to enter ST_LOBBY...");
 	RAssert(server);
 
@@ -625,7 +615,7 @@ bool lobby_init(Server* server)
 		else
 		{
 			if (v->id != server->game.exe)
-				v->exe_chance += 2 + rand() % 5;
+				v->exe_chance += 2 + rng_range(&server->rng, 5);
 
 			Packet pack;
 			PacketCreate(&pack, SERVER_LOBBY_EXE_CHANCE);
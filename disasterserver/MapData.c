@@ -0,0 +1,222 @@
+#include <MapData.h>
+#include <Log.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if (defined(__unix) || defined(__unix__)) && !defined(SYS_BIG_ENDIAN)
+	#define MAPDATA_MMAP
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+MapData g_mapData;
+
+/* Game code relies on these, e.g. Ravine Mist always spawns 7 shards */
+static const uint16_t spawn_min[SPAWN_COUNT] = { 1, 0, 7 };
+
+static uint16_t map_data_read16(const uint8_t* ptr)
+{
+	return (uint16_t)(ptr[0] | (ptr[1] << 8));
+}
+
+static uint32_t map_data_read32(const uint8_t* ptr)
+{
+	return (uint32_t)map_data_read16(ptr) | ((uint32_t)map_data_read16(ptr + 2) << 16);
+}
+
+static uint64_t map_data_stored_hash(const uint8_t* blob)
+{
+	return (uint64_t)map_data_read32(blob + 16) | ((uint64_t)map_data_read32(blob + 20) << 32);
+}
+
+static const uint8_t* map_data_range(const uint8_t* blob, size_t size, size_t index, size_t elem, size_t min, size_t max, uint16_t* count)
+{
+	const uint8_t* range = blob + MAPDATA_HEADER + index * MAPDATA_RANGE;
+	uint32_t offset = map_data_read32(range);
+	uint32_t num = map_data_read32(range + 4);
+
+	// Arrays are used in place, so they have to be aligned for their fields
+	if (num < min || num > max || offset % 4 != 0 || offset > size || num * elem > size - offset)
+		return NULL;
+
+	*count = (uint16_t)num;
+	return blob + offset;
+}
+
+#ifdef SYS_BIG_ENDIAN
+static void map_data_swap(uint8_t* ptr, size_t size, size_t width)
+{
+	for (size_t i = 0; i + width <= size; i += width)
+	{
+		for (size_t j = 0; j < width / 2; j++)
+		{
+			uint8_t tmp = ptr[i + j];
+			ptr[i + j] = ptr[i + width - 1 - j];
+			ptr[i + width - 1 - j] = tmp;
+		}
+	}
+}
+#endif
+
+static bool map_data_zones_valid(const ZoneRect* zones, size_t count)
+{
+	// Rejects NaN and infinities too, the grids are sized from these
+	for (size_t i = 0; i < count; i++)
+	{
+		const float values[4] = { zones[i].x, zones[i].y, zones[i].w, zones[i].h };
+		for (int j = 0; j < 4; j++)
+		{
+			if (!(values[j] >= -MAPDATA_COORD_MAX && values[j] <= MAPDATA_COORD_MAX))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static bool map_data_bind(uint8_t* blob, size_t size)
+{
+	if (size < MAPDATA_HEADER + (MAPDATA_MAPS + SPAWN_COUNT) * MAPDATA_RANGE)
+		return false;
+
+	if (map_data_read32(blob) != MAPDATA_MAGIC || map_data_read16(blob + 4) != MAPDATA_VERSION)
+		return false;
+
+	if (map_data_read16(blob + 6) != MAPDATA_MAPS || map_data_read16(blob + 8) != SPAWN_COUNT || map_data_read32(blob + 12) != size)
+		return false;
+
+	if (map_data_hash(blob, size) != map_data_stored_hash(blob))
+		return false;
+
+	MapData data;
+	for (size_t i = 0; i < MAPDATA_MAPS; i++)
+	{
+		data.zones[i] = (const ZoneRect*)map_data_range(blob, size, i, sizeof(ZoneRect), 0, UINT16_MAX, &data.zone_count[i]);
+		if (!data.zones[i])
+			return false;
+	}
+
+	for (size_t i = 0; i < SPAWN_COUNT; i++)
+	{
+		data.spawns[i] = (const SpawnPoint*)map_data_range(blob, size, MAPDATA_MAPS + i, sizeof(SpawnPoint), spawn_min[i], MAPDATA_MAXSPAWNS, &data.spawn_count[i]);
+		if (!data.spawns[i])
+			return false;
+	}
+
+#ifdef SYS_BIG_ENDIAN
+	// Swap the arrays once (blob was read into memory), zones are 32 bit fields and spawns 16 bit
+	for (size_t i = 0; i < MAPDATA_MAPS; i++)
+		map_data_swap((uint8_t*)data.zones[i], data.zone_count[i] * sizeof(ZoneRect), 4);
+
+	for (size_t i = 0; i < SPAWN_COUNT; i++)
+		map_data_swap((uint8_t*)data.spawns[i], data.spawn_count[i] * sizeof(SpawnPoint), 2);
+#endif
+
+	for (size_t i = 0; i < MAPDATA_MAPS; i++)
+	{
+		if (!map_data_zones_valid(data.zones[i], data.zone_count[i]))
+			return false;
+	}
+
+	g_mapData = data;
+	return true;
+}
+
+static bool map_data_load(const char* path, uint64_t builtin_hash)
+{
+	uint8_t* blob = NULL;
+	size_t size = 0;
+
+#ifdef MAPDATA_MMAP
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	size = (size_t)st.st_size;
+	void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED)
+	{
+		Warn("Failed to map %s", path);
+		return false;
+	}
+
+	blob = (uint8_t*)map;
+#else
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long len = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (len > 0)
+	{
+		size = (size_t)len;
+		blob = (uint8_t*)malloc(size);
+	}
+
+	if (!blob || fread(blob, 1, size, file) != size)
+	{
+		Warn("Failed to read %s", path);
+		fclose(file);
+		free(blob);
+		return false;
+	}
+
+	fclose(file);
+#endif
+
+	if (!map_data_bind(blob, size))
+	{
+		Warn("%s is not valid map data (version %d expected), ignoring it", path, MAPDATA_VERSION);
+#ifdef MAPDATA_MMAP
+		munmap(blob, size);
+#else
+		free(blob);
+#endif
+		return false;
+	}
+
+	// Stays mapped for the lifetime of the process
+	if (map_data_stored_hash(blob) == builtin_hash)
+		Info("Map data loaded from %s (%d bytes)", path, (int)size);
+	else
+		Info("Map data loaded from %s (%d bytes), overriding the built-in tables", path, (int)size);
+
+	return true;
+}
+
+bool map_data_init(const char* path)
+{
+	// Packed once either way, the hash tells whether the file differs from it
+	size_t size = map_data_pack(NULL, 0);
+	RAssert(size > 0);
+
+	uint8_t* blob = (uint8_t*)malloc(size);
+	RAssert(blob);
+	RAssert(map_data_pack(blob, size) == size);
+
+	if (map_data_load(path, map_data_stored_hash(blob)))
+	{
+		free(blob);
+		return true;
+	}
+
+	// Fall back to the tables compiled into the server
+	RAssert(map_data_bind(blob, size));
+
+	Info("Using built-in map data (%d bytes)", (int)size);
+	return true;
+}
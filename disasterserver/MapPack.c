@@ -0,0 +1,137 @@
+#include <MapData.h>
+#include <Zone.h>
+#include <math.h>
+#include <string.h>
+
+/* Kept free of logging and threads so PackMaps can link it on the host */
+
+static void pack_write16(uint8_t* out, size_t* pos, uint16_t value)
+{
+	if (out)
+	{
+		out[*pos] = (uint8_t)value;
+		out[*pos + 1] = (uint8_t)(value >> 8);
+	}
+	*pos += 2;
+}
+
+static void pack_write32(uint8_t* out, size_t* pos, uint32_t value)
+{
+	pack_write16(out, pos, (uint16_t)value);
+	pack_write16(out, pos, (uint16_t)(value >> 16));
+}
+
+static bool pack_zone(uint8_t* out, size_t* pos, double value)
+{
+	// Edges keep their sub-pixel part, 1/8 px steps are exact in a float and so are their sums
+	float stepped = (float)(round(value * MAPDATA_SUBPIXEL) / MAPDATA_SUBPIXEL);
+	if (!(stepped >= -MAPDATA_COORD_MAX && stepped <= MAPDATA_COORD_MAX))
+		return false;
+
+	uint32_t bits;
+	memcpy(&bits, &stepped, sizeof(bits));
+	pack_write32(out, pos, bits);
+	return true;
+}
+
+static bool pack_spawn(uint8_t* out, size_t* pos, float value)
+{
+	// Spawn tables are whole pixels, refuse anything that would move
+	if (!(value == floorf(value) && value >= -MAPDATA_COORD_MAX && value <= MAPDATA_COORD_MAX))
+		return false;
+
+	pack_write16(out, pos, (uint16_t)(int16_t)value);
+	return true;
+}
+
+uint64_t map_data_hash(const uint8_t* blob, size_t size)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (size_t i = MAPDATA_HEADER; i < size; i++)
+	{
+		hash ^= blob[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+size_t map_data_pack(uint8_t* out, size_t cap)
+{
+	size_t data = MAPDATA_HEADER + (MAPDATA_MAPS + SPAWN_COUNT) * MAPDATA_RANGE;
+	size_t size = data;
+
+	for (int i = 0; i < MAPDATA_MAPS; i++)
+	{
+		if (g_mapZoneSize[i] > UINT16_MAX)
+			return 0;
+
+		size += g_mapZoneSize[i] * sizeof(ZoneRect);
+	}
+
+	for (int i = 0; i < SPAWN_COUNT; i++)
+	{
+		if (g_spawnTableSize[i] > MAPDATA_MAXSPAWNS)
+			return 0;
+
+		size += g_spawnTableSize[i] * sizeof(SpawnPoint);
+	}
+
+	if (!out)
+		return size;
+
+	if (cap < size)
+		return 0;
+
+	size_t pos = 0;
+	pack_write32(out, &pos, MAPDATA_MAGIC);
+	pack_write16(out, &pos, MAPDATA_VERSION);
+	pack_write16(out, &pos, MAPDATA_MAPS);
+	pack_write16(out, &pos, SPAWN_COUNT);
+	pack_write16(out, &pos, 0);
+	pack_write32(out, &pos, (uint32_t)size);
+	pack_write32(out, &pos, 0);	// hash, filled in once the rest is written
+	pack_write32(out, &pos, 0);
+
+	size_t offset = data;
+	for (int i = 0; i < MAPDATA_MAPS; i++)
+	{
+		pack_write32(out, &pos, (uint32_t)offset);
+		pack_write32(out, &pos, (uint32_t)g_mapZoneSize[i]);
+		offset += g_mapZoneSize[i] * sizeof(ZoneRect);
+	}
+
+	for (int i = 0; i < SPAWN_COUNT; i++)
+	{
+		pack_write32(out, &pos, (uint32_t)offset);
+		pack_write32(out, &pos, (uint32_t)g_spawnTableSize[i]);
+		offset += g_spawnTableSize[i] * sizeof(SpawnPoint);
+	}
+
+	for (int i = 0; i < MAPDATA_MAPS; i++)
+	{
+		for (size_t j = 0; j < g_mapZoneSize[i]; j++)
+		{
+			const Zone* zone = &g_mapZone[i][j];
+			if (!pack_zone(out, &pos, zone->x) || !pack_zone(out, &pos, zone->y) ||
+				!pack_zone(out, &pos, zone->w) || !pack_zone(out, &pos, zone->h))
+				return 0;
+		}
+	}
+
+	for (int i = 0; i < SPAWN_COUNT; i++)
+	{
+		for (size_t j = 0; j < g_spawnTableSize[i]; j++)
+		{
+			const Vector2* point = &g_spawnTable[i][j];
+			if (!pack_spawn(out, &pos, point->x) || !pack_spawn(out, &pos, point->y))
+				return 0;
+		}
+	}
+
+	uint64_t hash = map_data_hash(out, pos);
+	size_t head = MAPDATA_HEADER - 8;
+	pack_write32(out, &head, (uint32_t)hash);
+	pack_write32(out, &head, (uint32_t)(hash >> 32));
+	return pos;
+}
@@ -68,7 +68,7 @@ bool map_tick(Server* server)
 	return true;
 }
 
-bool map_tcpmsg(PeerData* v, Packet* packet)
+bool map_tcpmsg(PeerData* v, PacketView* packet)
 {
 	return true;
 }
@@ -32,7 +32,7 @@ bool mapvote_check_state(Server* server)
 	return true;
 }
 
-bool mapvote_state_handle(PeerData* v, Packet* packet)
+bool mapvote_state_handle(PeerData* v, PacketView* packet)
 {
 	// Read header
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
@@ -75,7 +75,7 @@ bool mapvote_state_handle(PeerData* v, Packet* packet)
 			v->timeout = 0;
 			Info("%s " LOG_RST "(id %d): %s", v->nickname.value, v->id, msg.value);
 			if (!server_cmd_handle(v->server, server_cmd_parse(&msg), v, &msg))
-				server_broadcast_ex(v->server, packet, true, v->id);
+				server_relay(v->server, packet, true, v->id);
 
 			break;
 		}
@@ -120,7 +120,7 @@ bool mapvote_state_tick(Server* server)
 			}
 
 			// Find winner
-			int8_t won = indeces[rand() % count];
+			int8_t won = indeces[rng_range(&server->rng, count)];
 			server->last_map = won;
 			
 			// Decrease pickrate
@@ -168,11 +168,6 @@ bool mapvote_init(Server* server)
 	Debug("Attepting to enter ST_MAPVOTE...");
 	RAssert(server);
 
-	// randomize
-	time_t seed = time(NULL);
-	Debug("Mapvote seed: %d", seed);
-	srand((unsigned int)seed);
-
 	RAssert(server);
 	server->state = ST_MAPVOTE;
 	server->lobby.countdown_sec = 30;
@@ -206,12 +201,12 @@ bool mapvote_init(Server* server)
 		for (int i = 0; i < 3; i++)
 		{
 		gen:
-			map = allowed[rand() % allowed_count];
+			map = allowed[rng_range(&server->rng, allowed_count)];
 
 			if (map == server->last_map)
 				goto gen;
 
-			int num = rand() % 255;
+			int num = rng_range(&server->rng, 255);
 			if (num >= server->map_pickrates[map])
 			{
 				Debug("%d vs %d lost", num, server->map_pickrates[map]);
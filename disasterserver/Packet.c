@@ -4,16 +4,6 @@
 #include <CMath.h>
 #include <Server.h>
 
-#ifdef __GNUC__ // GCC, clang...
-	#define BYTESWAP_16(x) __builtin_bswap16((x))
-	#define BYTESWAP_32(x) __builtin_bswap32((x))
-	#define BYTESWAP_64(x) __builtin_bswap64((x))
-#else
-	#define BYTESWAP_16(x) _byteswap_ushort((x))
-	#define BYTESWAP_32(x) _byteswap_ulong((x))
-	#define BYTESWAP_64(x) _byteswap_uint64((x))
-#endif
-
 String string_new(const char* value)
 {
 	size_t len = strlen(value) + 1;
@@ -49,6 +39,8 @@ String string_lower(String str)
 bool packet_new(Packet* packet, PacketType type)
 {
 	RAssert(packet);
+	packet->ext = NULL;
+	packet->cap = PACKET_MAXSIZE;
 	packet->len = 0;
 	packet->pos = 0;
 
@@ -58,12 +50,15 @@ bool packet_new(Packet* packet, PacketType type)
 	return true;
 }
 
-Packet packet_from(ENetPacket* packet)
+PacketView packet_view(ENetPacket* packet)
+{
+	return (PacketView) { .data = packet->data, .pos = 0, .len = packet->dataLength, .source = packet };
+}
+
+ENetPacket* packet_build(Packet* packet, bool reliable)
 {
-	Packet pack = (Packet) { .pos = 0,  .len = (uint8_t)packet->dataLength };
-	memcpy(pack.buff, packet->data, (uint8_t)packet->dataLength);
-	enet_packet_destroy(packet);
-	return pack;
+	packet->pos = 0;
+	return enet_packet_create(packet_data(packet), packet->len, reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
 }
 
 bool packet_send(ENetPeer* peer, Packet* packet, bool reliable)
@@ -73,15 +68,26 @@ bool packet_send(ENetPeer* peer, Packet* packet, bool reliable)
 		return true;
 
 	packet->pos = 0;
-	ENetPacket* pack = enet_packet_create(packet, packet->len, reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
-	return enet_peer_send(peer, reliable ? 0 : 1, pack) == 0;
+	if (data)
+		data->idle = 0;
+
+	if (data && data->ext_proto)
+		return packet_bundle_append(data, packet_data(packet), packet->len, reliable);
+
+	ENetPacket* pack = packet_build(packet, reliable);
+	RAssert(pack);
+
+	if (enet_peer_send(peer, reliable ? 0 : 1, pack) != 0)
+	{
+		enet_packet_destroy(pack);
+		return false;
+	}
+
+	return true;
 }
 
 bool packet_send_id(struct Server* server, uint16_t id, Packet* packet, bool reliable)
 {
-	packet->pos = 0;
-	ENetPacket* pack = enet_packet_create(packet, packet->len, reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
-
 	for(int32_t i = 0; i < server->peers.capacity; i++)
 	{
 		PeerData* data = (PeerData*)server->peers.ptr[i];
@@ -91,238 +97,243 @@ bool packet_send_id(struct Server* server, uint16_t id, Packet* packet, bool rel
 		if(data->id != id)
 			continue;
 			
-		return enet_peer_send(data->peer, reliable ? 0 : 1, pack) == 0;
+		return packet_send(data->peer, packet, reliable);
 	}
 
 	return false;
 }
 
-bool packet_seek(Packet* packet, int wh)
+bool packet_bundle_append(struct PeerData* peer, const uint8_t* data, size_t len, bool reliable)
 {
-	RAssert(wh >= 0);
-	RAssert(wh < PACKET_MAXSIZE);
-	RAssert(wh < packet->len);
+	PacketBundle* bundle = &peer->bundle[reliable ? 0 : 1];
 
-	packet->pos = wh;
-	return true;
-}
+	// Too big to be framed, flush what we have so order is kept and send as is
+	if (len + 4 > BUNDLE_MAXSIZE)
+	{
+		RAssert(packet_bundle_flush(peer));
 
-bool packet_read8(Packet* packet, uint8_t* out)
-{
-	RAssert(packet->pos < packet->len);
-	*out = packet->buff[packet->pos++];
+		ENetPacket* pack = enet_packet_create(data, len, reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
+		RAssert(pack);
 
-	return true;
-}
+		if (enet_peer_send(peer->peer, reliable ? 0 : 1, pack) != 0)
+		{
+			enet_packet_destroy(pack);
+			return false;
+		}
 
-bool packet_read16(Packet* packet, uint16_t* out)
-{
-	RAssert(packet->pos < packet->len);
-	*out = *((int16_t*)&packet->buff[packet->pos]);
+		return true;
+	}
 
-#ifdef SYS_BIG_ENDIAN
-	*out = BYTESWAP_16(*out);
-#endif
+	if (bundle->len + 2 + len > BUNDLE_MAXSIZE)
+		RAssert(packet_bundle_flush(peer));
+
+	if (bundle->len == 0)
+	{
+		bundle->buff[bundle->len++] = 0;
+		bundle->buff[bundle->len++] = SERVER_BUNDLE;
+	}
 
-	packet->pos += 2;
+	// Each message is prefixed by its length (16 bit, little endian)
+	bundle->buff[bundle->len++] = (uint8_t)(len & 0xFF);
+	bundle->buff[bundle->len++] = (uint8_t)(len >> 8);
+	memcpy(&bundle->buff[bundle->len], data, len);
+	bundle->len += (uint16_t)len;
+	bundle->count++;
 
 	return true;
 }
 
-bool packet_read32(Packet* packet, uint32_t* out)
+bool packet_bundle_flush(struct PeerData* peer)
 {
-	RAssert(packet->pos < packet->len);
-	*out = *((int32_t*)&packet->buff[packet->pos]);
+	bool res = true;
 
-#ifdef SYS_BIG_ENDIAN
-	*out = BYTESWAP_32(*out);
-#endif
+	for (int i = 0; i < 2; i++)
+	{
+		PacketBundle* bundle = &peer->bundle[i];
+		if (bundle->count == 0)
+			continue;
+
+		ENetPacket* pack;
+		if (bundle->count == 1)
+		{
+			// Single message doesn't need the framing
+			pack = enet_packet_create(&bundle->buff[4], bundle->len - 4, i == 0 ? ENET_PACKET_FLAG_RELIABLE : 0);
+		}
+		else
+			pack = enet_packet_create(bundle->buff, bundle->len, i == 0 ? ENET_PACKET_FLAG_RELIABLE : 0);
+
+		peer->server->net.bundled += bundle->count;
+		peer->server->net.bundles++;
+		bundle->len = 0;
+		bundle->count = 0;
+
+		if (!pack)
+		{
+			res = false;
+			continue;
+		}
 
-	packet->pos += 4;
+		if (enet_peer_send(peer->peer, (enet_uint8)i, pack) != 0)
+		{
+			enet_packet_destroy(pack);
+			res = false;
+		}
+	}
 
-	return true;
+	return res;
 }
 
-bool packet_read64(Packet* packet, uint64_t* out)
+bool packet_seek(PacketView* packet, size_t wh)
 {
-	RAssert(packet->pos < packet->len);
-	*out = *((int64_t*)&packet->buff[packet->pos]);
-
-#ifdef SYS_BIG_ENDIAN
-	*out = BYTESWAP_64(*out);
-#endif
-
-	packet->pos += 8;
+	RAssert(wh < packet->len);
 
+	packet->pos = wh;
 	return true;
 }
 
-bool packet_readfloat(Packet* packet, float* out)
+bool packet_readstr(PacketView* packet, String* out)
 {
-	RAssert(packet->pos < packet->len);
-	*out = *((float*)&packet->buff[packet->pos]);
-
-#ifdef SYS_BIG_ENDIAN
-	*out = BYTESWAP_32(*out);
-#endif
+	// Find the terminator first so the whole string is copied in one go
+	size_t left = packet->len - packet->pos;
+	const uint8_t* end = memchr(&packet->data[packet->pos], '\0', left < 128 ? left : 128);
+	RAssert(end);
 
-	packet->pos += 4;
+	out->len = (uint16_t)(end - &packet->data[packet->pos] + 1);
+	memcpy(out->value, &packet->data[packet->pos], out->len);
+	packet->pos += out->len;
 
 	return true;
 }
 
-bool packet_readdouble(Packet* packet, double* out)
+bool packet_arena_init(PacketArena* arena)
 {
-	RAssert(packet->pos < packet->len);
-	*out = *((float*)&packet->buff[packet->pos]);
+	arena->buff = (uint8_t*)malloc(PACKET_ARENA_SIZE);
+	arena->used = 0;
+	RAssert(arena->buff);
 
-#ifdef SYS_BIG_ENDIAN
-	* out = BYTESWAP_32(*out);
-#endif
+	ThreadVarSet(g_packetArena, arena);
+	return true;
+}
+
+void packet_arena_reset(PacketArena* arena)
+{
+	arena->used = 0;
+}
 
-	packet->pos += 8;
+void packet_arena_free(PacketArena* arena)
+{
+	ThreadVarSet(g_packetArena, NULL);
 
-	return true;
+	free(arena->buff);
+	arena->buff = NULL;
 }
 
-bool packet_readstr(Packet* packet, String* out)
+static uint8_t* packet_reserve(Packet* packet, size_t size)
 {
-	out->len = 0;
+	size_t end = (size_t)packet->pos + size;
+	if (end <= packet->cap)
+		return &packet_data(packet)[packet->pos];
+
+	if (end > PACKET_MAXGROWN)
+	{
+		Err("Packet would grow past %d bytes!", PACKET_MAXGROWN);
+		return NULL;
+	}
 
-	while (1)
+	// Only worker threads have an arena, everyone else is capped to buff
+	PacketArena* arena = (PacketArena*)ThreadVarGet(g_packetArena);
+	if (!arena)
 	{
-		RAssert(packet->pos < packet->len);
-		RAssert(out->len < 128);
+		Err("Packet outgrew %d bytes outside of a worker!", PACKET_MAXSIZE);
+		return NULL;
+	}
 
-		char ch = packet->buff[packet->pos];
-		out->value[out->len] = ch;
+	size_t cap = (size_t)packet->cap * 2;
+	while (cap < end)
+		cap *= 2;
 
-		packet->pos++;
-		out->len++;
+	if (cap > PACKET_MAXGROWN)
+		cap = PACKET_MAXGROWN;
 
-		if (ch == '\0')
-			break;
+	if (arena->used + cap > PACKET_ARENA_SIZE)
+	{
+		Err("Packet arena exhausted (%d bytes used)", (int)arena->used);
+		return NULL;
 	}
 
-	return true;
+	uint8_t* mem = &arena->buff[arena->used];
+	arena->used += cap;
+
+	memcpy(mem, packet_data(packet), packet->len);
+	packet->ext = mem;
+	packet->cap = (uint16_t)cap;
+
+	return &packet->ext[packet->pos];
 }
 
-bool packet_write8(Packet* packet, uint8_t value)
+bool packet_writeblob(Packet* packet, const void* data, size_t len)
 {
-	RAssert(packet->pos + 1 < PACKET_MAXSIZE);
+	uint8_t* ptr = packet_reserve(packet, len);
+	RAssert(ptr);
+
+	memcpy(ptr, data, len);
+	packet->pos += (uint16_t)len;
 
-	if (packet->pos + 1 >= packet->len)
-		packet->len++;
+	if (packet->pos > packet->len)
+		packet->len = packet->pos;
 
-	packet->buff[packet->pos++] = value;
 	return true;
 }
 
-bool packet_write16(Packet* packet, uint16_t value)
+bool packet_write8(Packet* packet, uint8_t value)
 {
-	RAssert(packet->pos + 2 < PACKET_MAXSIZE);
-
-	if (packet->pos + 2 >= packet->len)
-		packet->len += 2;
+	return packet_writeblob(packet, &value, 1);
+}
 
+bool packet_write16(Packet* packet, uint16_t value)
+{
 #ifdef SYS_BIG_ENDIAN
 	value = BYTESWAP_16(value);
 #endif
 
-	uint8_t* ptr = (uint8_t*)&value;
-	packet->buff[packet->pos++] = ptr[0];
-	packet->buff[packet->pos++] = ptr[1];
-	return true;
+	return packet_writeblob(packet, &value, 2);
 }
 
 bool packet_write32(Packet* packet, uint32_t value)
 {
-	RAssert(packet->pos + 4 < PACKET_MAXSIZE);
-
-	if (packet->pos + 4 >= packet->len)
-		packet->len += 4;
-
 #ifdef SYS_BIG_ENDIAN
 	value = BYTESWAP_32(value);
 #endif
 
-	uint8_t* ptr = (uint8_t*)&value;
-	packet->buff[packet->pos++] = ptr[0];
-	packet->buff[packet->pos++] = ptr[1];
-	packet->buff[packet->pos++] = ptr[2];
-	packet->buff[packet->pos++] = ptr[3];
-	return true;
+	return packet_writeblob(packet, &value, 4);
 }
 
 bool packet_write64(Packet* packet, uint64_t value)
 {
-	RAssert(packet->pos + 8 < PACKET_MAXSIZE);
-
-	if (packet->pos + 8 >= packet->len)
-		packet->len += 8;
-
 #ifdef SYS_BIG_ENDIAN
 	value = BYTESWAP_64(value);
 #endif
 
-	uint8_t* ptr = (uint8_t*)&value;
-	packet->buff[packet->pos++] = ptr[0];
-	packet->buff[packet->pos++] = ptr[1];
-	packet->buff[packet->pos++] = ptr[2];
-	packet->buff[packet->pos++] = ptr[3];
-	packet->buff[packet->pos++] = ptr[4];
-	packet->buff[packet->pos++] = ptr[5];
-	packet->buff[packet->pos++] = ptr[6];
-	packet->buff[packet->pos++] = ptr[7];
-	return true;
+	return packet_writeblob(packet, &value, 8);
 }
 
 bool packet_writefloat(Packet* packet, float value)
 {
-	RAssert(packet->pos + 4 < PACKET_MAXSIZE);
+	uint32_t raw;
+	memcpy(&raw, &value, 4);
 
-	if (packet->pos + 4 >= packet->len)
-		packet->len += 4;
-
-#ifdef SYS_BIG_ENDIAN
-	value = BYTESWAP_32(value);
-#endif
-
-	uint8_t* ptr = (uint8_t*)&value;
-	packet->buff[packet->pos++] = ptr[0];
-	packet->buff[packet->pos++] = ptr[1];
-	packet->buff[packet->pos++] = ptr[2];
-	packet->buff[packet->pos++] = ptr[3];
-	return true;
+	return packet_write32(packet, raw);
 }
 
 bool packet_writedouble(Packet* packet, double value)
 {
-	RAssert(packet->pos + 8 < PACKET_MAXSIZE);
+	uint64_t raw;
+	memcpy(&raw, &value, 8);
 
-	if (packet->pos + 8 >= packet->len)
-		packet->len += 8;
-
-#ifdef SYS_BIG_ENDIAN
-	value = BYTESWAP_64(value);
-#endif
-
-	uint8_t* ptr = (uint8_t*)&value;
-	packet->buff[packet->pos++] = ptr[0];
-	packet->buff[packet->pos++] = ptr[1];
-	packet->buff[packet->pos++] = ptr[2];
-	packet->buff[packet->pos++] = ptr[3];
-	packet->buff[packet->pos++] = ptr[4];
-	packet->buff[packet->pos++] = ptr[5];
-	packet->buff[packet->pos++] = ptr[6];
-	packet->buff[packet->pos++] = ptr[7];
-	return true;
+	return packet_write64(packet, raw);
 }
 
 bool packet_writestr(Packet* packet, String value)
 {
-	for (uint8_t i = 0; i < value.len; i++)
-		RAssert(packet_write8(packet, value.value[i]));
-
-	return true;
+	return packet_writeblob(packet, value.value, value.len);
 }
@@ -100,7 +100,7 @@ bool palette_within_epsilon(uint8_t a, uint8_t b)
     return a >= b - PALETTE_EPSILON && a <= b + PALETTE_EPSILON;
 }
 
-bool palette_player_validate(PeerData* v, Packet* packet)
+bool palette_player_validate(PeerData* v, PacketView* packet)
 {
     PacketRead(from, packet, packet_read8, uint8_t);
     PacketRead(id, packet, packet_read16, uint16_t);
@@ -0,0 +1,128 @@
+#include <PeerSet.h>
+#include <Log.h>
+#include <ctype.h>
+
+static PeerSetShard shards[PEERSET_SHARDS];
+
+static uint64_t peer_set_mix(uint64_t hash)
+{
+	// Final avalanche so both the shard and the slot bits are well spread
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	return hash ? hash : 1;
+}
+
+uint64_t peer_set_key_ip(const IpAddr* addr)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (int i = 0; i < 16; i++)
+	{
+		hash ^= addr->bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return peer_set_mix(hash);
+}
+
+uint64_t peer_set_key_udid(const char* udid)
+{
+	// Case-insensitive like the cJSON lookup it replaces, seeded apart from addresses
+	uint64_t hash = 0x84222325cbf29ce4ULL;
+	for (; *udid; udid++)
+	{
+		hash ^= (uint8_t)tolower((unsigned char)*udid);
+		hash *= 0x100000001b3ULL;
+	}
+
+	return peer_set_mix(hash);
+}
+
+static inline PeerSetShard* peer_set_shard(uint64_t key)
+{
+	return &shards[key >> 60 & (PEERSET_SHARDS - 1)];
+}
+
+/* Linear probe, returns the key's slot or the free one ending its run */
+static PeerSetSlot* peer_set_find(PeerSetShard* shard, uint64_t key)
+{
+	for (uint32_t i = 0, n = (uint32_t)key & (PEERSET_SLOTS - 1); i < PEERSET_SLOTS; i++, n = (n + 1) & (PEERSET_SLOTS - 1))
+	{
+		PeerSetSlot* slot = &shard->slots[n];
+		if (!slot->hash || slot->hash == key)
+			return slot;
+	}
+
+	return NULL;
+}
+
+bool peer_set_has(uint64_t key)
+{
+	PeerSetShard* shard = peer_set_shard(key);
+	bool res;
+
+	SpinLock(shard->lock);
+	{
+		PeerSetSlot* slot = peer_set_find(shard, key);
+		res = slot && slot->hash == key;
+	}
+	SpinUnlock(shard->lock);
+
+	return res;
+}
+
+bool peer_set_add(uint64_t key)
+{
+	PeerSetShard* shard = peer_set_shard(key);
+	bool res = true;
+
+	SpinLock(shard->lock);
+	{
+		PeerSetSlot* slot = peer_set_find(shard, key);
+		if (slot && slot->hash == key)
+			slot->count++;
+		else if (slot && shard->count < PEERSET_SLOTS * 3 / 4)
+		{
+			slot->hash = key;
+			slot->count = 1;
+			shard->count++;
+		}
+		else
+			res = false;
+	}
+	SpinUnlock(shard->lock);
+
+	if (!res)
+		Warn("Connection set shard is full, duplicate check skipped");
+
+	return res;
+}
+
+void peer_set_remove(uint64_t key)
+{
+	PeerSetShard* shard = peer_set_shard(key);
+
+	SpinLock(shard->lock);
+	{
+		PeerSetSlot* slot = peer_set_find(shard, key);
+		if (slot && slot->hash == key && --slot->count == 0)
+		{
+			// Backward shift deletion, pull later entries of the run into the hole
+			uint32_t hole = (uint32_t)(slot - shard->slots);
+			for (uint32_t n = (hole + 1) & (PEERSET_SLOTS - 1); shard->slots[n].hash; n = (n + 1) & (PEERSET_SLOTS - 1))
+			{
+				uint32_t home = (uint32_t)shard->slots[n].hash & (PEERSET_SLOTS - 1);
+				if (((n - home) & (PEERSET_SLOTS - 1)) >= ((n - hole) & (PEERSET_SLOTS - 1)))
+				{
+					shard->slots[hole] = shard->slots[n];
+					hole = n;
+				}
+			}
+
+			shard->slots[hole].hash = 0;
+			shard->slots[hole].count = 0;
+			shard->count--;
+		}
+	}
+	SpinUnlock(shard->lock);
+}
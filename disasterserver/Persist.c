@@ -0,0 +1,210 @@
+#include <Persist.h>
+#include <io/Threads.h>
+#include <Log.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+	Intrusive MPSC queue (Vyukov): producers swap themselves in as the
+	head and then link the previous head to them, the persistence thread
+	is the only consumer and walks from the tail. A producer preempted
+	between the two steps briefly hides the records behind it, the
+	consumer just picks them up on its next drain.
+*/
+static PersistRecord	stub;
+static PersistRecord*	head = &stub;
+static PersistRecord*	tail = &stub;
+
+static Store*			stores[PERSIST_MAXSTORES];
+static size_t			store_count;
+static Thread			thread;
+static int32_t			stopping;
+static int32_t			stopped;
+
+static void persist_enqueue(PersistRecord* record)
+{
+	AtomicStorePtr(&record->next, NULL);
+	PersistRecord* prev = (PersistRecord*)AtomicExchangePtr(&head, record);
+	AtomicStorePtr(&prev->next, record);
+}
+
+static PersistRecord* persist_dequeue(void)
+{
+	PersistRecord* first = tail;
+	PersistRecord* next = (PersistRecord*)AtomicLoadPtr(&first->next);
+
+	if (first == &stub)
+	{
+		if (!next)
+			return NULL;
+
+		tail = next;
+		first = next;
+		next = (PersistRecord*)AtomicLoadPtr(&next->next);
+	}
+
+	if (next)
+	{
+		tail = next;
+		return first;
+	}
+
+	// first is the newest record, a producer may be linking past it right now
+	if (first != (PersistRecord*)AtomicLoadPtr(&head))
+		return NULL;
+
+	persist_enqueue(&stub);
+	next = (PersistRecord*)AtomicLoadPtr(&first->next);
+	if (next)
+	{
+		tail = next;
+		return first;
+	}
+
+	return NULL;
+}
+
+static void persist_drain(void)
+{
+	bool dirty[PERSIST_MAXSTORES] = { 0 };
+	PersistRecord* record;
+
+	while ((record = persist_dequeue()))
+	{
+		Store* store = record->store;
+
+		// Compaction already put it into the JSON file
+		if (record->seq > store->saved_seq)
+			store_log(store, record->op, record->key, record->name, record->value);
+
+		for (size_t i = 0; i < store_count; i++)
+		{
+			if (stores[i] == store)
+				dirty[i] = true;
+		}
+
+		free(record);
+	}
+
+	// Coalesce everything a drain wrote into one flush per journal
+	for (size_t i = 0; i < store_count; i++)
+	{
+		if (dirty[i])
+			store_flush(stores[i]);
+	}
+}
+
+static bool persist_expire(Store* store)
+{
+	uint64_t now = (uint64_t)time(NULL);
+
+	// Short batches, lobbies wait on this lock to check timeouts
+	size_t count;
+	do
+	{
+		MutexLock(*store->lock);
+		{
+			count = store_expire(store, now, PERSIST_EXPIRE_BATCH);
+		}
+		MutexUnlock(*store->lock);
+	} while (count == PERSIST_EXPIRE_BATCH);
+
+	return true;
+}
+
+static bool persist_compact(Store* store)
+{
+	char* json;
+	uint64_t seq;
+
+	MutexLock(*store->lock);
+	{
+		json = store_snapshot(store, &seq);
+	}
+	MutexUnlock(*store->lock);
+
+	RAssert(json);
+	bool res = store_save(store, json, seq);
+	free(json);
+
+	return res;
+}
+
+static void* persist_worker(void* arg)
+{
+	(void)arg;
+	ThreadVarSet(g_threadName, "Persist Thr");
+
+	while (true)
+	{
+		// Read first so the final drain sees everything queued before persist_stop
+		bool last = AtomicLoad32(&stopping) != 0;
+
+		persist_drain();
+		for (size_t i = 0; i < store_count; i++)
+		{
+			if (stores[i]->timed)
+				persist_expire(stores[i]);
+
+			if (store_due(stores[i]))
+				persist_compact(stores[i]);
+		}
+
+		if (last)
+			break;
+
+		ThreadSleep(PERSIST_INTERVAL);
+	}
+
+	AtomicStore32(&stopped, 1);
+	return NULL;
+}
+
+bool persist_init(Store** list, size_t count)
+{
+	RAssert(count <= PERSIST_MAXSTORES);
+
+	memcpy(stores, list, count * sizeof(Store*));
+	store_count = count;
+
+	ThreadSpawn(thread, persist_worker, NULL);
+	return true;
+}
+
+bool persist_push(Store* store, uint64_t seq, char op, const char* key, const char* name, uint64_t value)
+{
+	size_t key_len = strlen(key) + 1;
+	size_t name_len = name ? strlen(name) + 1 : 0;
+
+	// One allocation, strings live right after the record
+	PersistRecord* record = (PersistRecord*)malloc(sizeof(PersistRecord) + key_len + name_len);
+	RAssert(record);
+
+	record->store = store;
+	record->seq = seq;
+	record->value = value;
+	record->op = op;
+	record->key = (char*)(record + 1);
+	memcpy(record->key, key, key_len);
+
+	record->name = NULL;
+	if (name)
+	{
+		record->name = record->key + key_len;
+		memcpy(record->name, name, name_len);
+	}
+
+	persist_enqueue(record);
+	return true;
+}
+
+void persist_stop(void)
+{
+	if (!store_count || AtomicLoad32(&stopped))
+		return;
+
+	AtomicStore32(&stopping, 1);
+	while (!AtomicLoad32(&stopped))
+		ThreadSleep(10);
+}
@@ -1,6 +1,7 @@
 #include <Player.h>
 #include <Server.h>
 #include <Zone.h>
+#include <MapData.h>
 
 bool player_add_error(Server* server, PeerData* v, uint16_t by)
 {
@@ -24,19 +25,41 @@ void player_check_zone(Server* server, PeerData* v)
 	if (!server->game.started)
 		return;
 
-	if (v->plr.pos.x == 0 && v->plr.pos.y == 0)
+	// Same as checking every zone each tick, the hits only change with pos
+	for (uint8_t i = 0; i < v->plr.zone_hits; i++)
+	{
+		if (!player_add_error(server, v, server->game.map == 6 ? 30 : 1000))
+			return;
+	}
+}
+
+void player_update_zone(Server* server, PeerData* v, Vector2 pos)
+{
+	if (v->plr.zone_valid && pos.x == v->plr.pos.x && pos.y == v->plr.pos.y)
 		return;
 
-	const Zone* zones = g_mapZone[server->game.map];
-	const size_t zonesSize = g_mapZoneSize[server->game.map];
-	for (size_t i = 0; i < zonesSize; i++)
+	v->plr.zone_hits = 0;
+	if (pos.x == 0 && pos.y == 0)
+		return;
+
+	// Candidates only change when crossing into another cell
+	int32_t cell = zone_grid_cell(server->game.map, pos.x, pos.y);
+	if (!v->plr.zone_valid || cell != v->plr.zone_cell)
+	{
+		v->plr.zone_cell = cell;
+		v->plr.zone_ncands = zone_grid_list(server->game.map, cell, &v->plr.zone_cands);
+	}
+
+	v->plr.zone_valid = true;
+
+	const ZoneRect* zones = g_mapData.zones[server->game.map];
+	for (size_t i = 0; i < v->plr.zone_ncands; i++)
 	{
-		const Zone zone = zones[i];
-		if (v->plr.pos.x >= zone.x && v->plr.pos.y >= zone.y && v->plr.pos.x <= zone.x + zone.w && v->plr.pos.y <= zone.y + zone.h)
+		const ZoneRect zone = zones[v->plr.zone_cands[i]];
+		if (pos.x >= zone.x && pos.y >= zone.y && pos.x <= zone.x + zone.w && pos.y <= zone.y + zone.h)
 		{
-			Debug("%d is inside invalid area %d", v->id, i);
-			if (!player_add_error(server, v, server->game.map == 6 ? 30 : 1000))
-				return;
+			Debug("%d is inside invalid area %d", v->id, v->plr.zone_cands[i]);
+			v->plr.zone_hits++;
 		}
 	}
 }
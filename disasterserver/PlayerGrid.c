@@ -0,0 +1,210 @@
+#include <PlayerGrid.h>
+#include <Server.h>
+#include <stdlib.h>
+
+/* Keeps cell math in range for garbage positions sent by clients */
+#define CELL_LIMIT (1 << 20)
+
+static int32_t player_grid_coord(float value)
+{
+	float cell = floorf(value / PLAYERGRID_CELL);
+	if (!(cell > -CELL_LIMIT))
+		return -CELL_LIMIT;
+
+	if (cell > CELL_LIMIT)
+		return CELL_LIMIT;
+
+	return (int32_t)cell;
+}
+
+static uint32_t player_grid_bucket(int32_t cx, int32_t cy)
+{
+	return ((uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u) % PLAYERGRID_BUCKETS;
+}
+
+bool player_grid_build(PlayerGrid* grid, Server* server)
+{
+	if (grid->capacity < server->peers.capacity)
+	{
+		PlayerGridItem* items = (PlayerGridItem*)realloc(grid->items, server->peers.capacity * sizeof(PlayerGridItem));
+		RAssert(items);
+		grid->items = items;
+
+		float* xs = (float*)realloc(grid->xs, server->peers.capacity * sizeof(float));
+		RAssert(xs);
+		grid->xs = xs;
+
+		float* ys = (float*)realloc(grid->ys, server->peers.capacity * sizeof(float));
+		RAssert(ys);
+		grid->ys = ys;
+
+		grid->capacity = server->peers.capacity;
+	}
+
+	// Counting sort by bucket, peers keep their order inside a bucket
+	memset(grid->start, 0, sizeof(grid->start));
+	for (size_t i = 0; i < server->peers.capacity; i++)
+	{
+		PeerData* data = (PeerData*)server->peers.ptr[i];
+		if (!data || !data->in_game)
+			continue;
+
+		int32_t cx = player_grid_coord(data->plr.pos.x);
+		int32_t cy = player_grid_coord(data->plr.pos.y);
+		grid->start[player_grid_bucket(cx, cy) + 1]++;
+	}
+
+	for (size_t i = 0; i < PLAYERGRID_BUCKETS; i++)
+		grid->start[i + 1] += grid->start[i];
+
+	uint16_t fill[PLAYERGRID_BUCKETS];
+	memcpy(fill, grid->start, sizeof(fill));
+
+	size_t count = 0;
+	for (size_t i = 0; i < server->peers.capacity; i++)
+	{
+		PeerData* data = (PeerData*)server->peers.ptr[i];
+		if (!data || !data->in_game)
+			continue;
+
+		PlayerGridItem item = { data, (uint32_t)i, player_grid_coord(data->plr.pos.x), player_grid_coord(data->plr.pos.y) };
+		uint16_t slot = fill[player_grid_bucket(item.cx, item.cy)]++;
+
+		grid->items[slot] = item;
+		grid->xs[slot] = data->plr.pos.x;
+		grid->ys[slot] = data->plr.pos.y;
+		count++;
+	}
+
+	grid->count = count;
+	return true;
+}
+
+void player_grid_remove(PlayerGrid* grid, PeerData* peer)
+{
+	// Left peers are freed before the next rebuild
+	for (size_t i = 0; i < grid->count; i++)
+	{
+		if (grid->items[i].peer == peer)
+			grid->items[i].peer = NULL;
+	}
+}
+
+void player_grid_free(PlayerGrid* grid)
+{
+	free(grid->items);
+	free(grid->xs);
+	free(grid->ys);
+	memset(grid, 0, sizeof(PlayerGrid));
+}
+
+typedef struct
+{
+	float			x0, y0, x1, y1;		/* Bounds, inclusive */
+	const Vector2*	center;				/* Set for radius queries */
+	float			radius;
+} GridQuery;
+
+/* Results go to one of the two, plain peers or whole items */
+typedef struct
+{
+	PeerData**				peers;
+	const PlayerGridItem**	items;
+} GridOut;
+
+static uint64_t player_grid_mask(const PlayerGrid* grid, const GridQuery* query, size_t begin, size_t count)
+{
+	// Being within the radius implies being within the bounds
+	if (query->center)
+		return vector2_within(query->center, &grid->xs[begin], &grid->ys[begin], count, query->radius);
+
+	uint64_t mask = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		float x = grid->xs[begin + i], y = grid->ys[begin + i];
+		if (x >= query->x0 && x <= query->x1 && y >= query->y0 && y <= query->y1)
+			mask |= (uint64_t)1 << i;
+	}
+
+	return mask;
+}
+
+static size_t player_grid_range(const PlayerGrid* grid, const GridQuery* query, size_t begin, size_t end, const int32_t* cell, GridOut* out, size_t found, size_t max)
+{
+	for (size_t base = begin; base < end && found < max; base += 64)
+	{
+		size_t count = end - base < 64 ? end - base : 64;
+		uint64_t mask = player_grid_mask(grid, query, base, count);
+
+		for (size_t i = 0; mask && found < max; i++, mask >>= 1)
+		{
+			if (!(mask & 1))
+				continue;
+
+			// Buckets are shared by several cells, only take the queried one
+			const PlayerGridItem* item = &grid->items[base + i];
+			if (!item->peer || (cell && (item->cx != cell[0] || item->cy != cell[1])))
+				continue;
+
+			if (out->items)
+				out->items[found++] = item;
+			else
+				out->peers[found++] = item->peer;
+		}
+	}
+
+	return found;
+}
+
+static size_t player_grid_query(const PlayerGrid* grid, const GridQuery* query, GridOut* out, size_t max)
+{
+	size_t found = 0;
+	int32_t cx0 = player_grid_coord(query->x0), cy0 = player_grid_coord(query->y0);
+	int32_t cx1 = player_grid_coord(query->x1), cy1 = player_grid_coord(query->y1);
+
+	// A query spanning more cells than there are players is cheaper as a scan
+	if ((int64_t)(cx1 - cx0 + 1) * (cy1 - cy0 + 1) > (int64_t)grid->count)
+		return player_grid_range(grid, query, 0, grid->count, NULL, out, 0, max);
+
+	for (int32_t cy = cy0; cy <= cy1 && found < max; cy++)
+	{
+		for (int32_t cx = cx0; cx <= cx1 && found < max; cx++)
+		{
+			int32_t cell[2] = { cx, cy };
+			uint32_t bucket = player_grid_bucket(cx, cy);
+			found = player_grid_range(grid, query, grid->start[bucket], grid->start[bucket + 1], cell, out, found, max);
+		}
+	}
+
+	return found;
+}
+
+size_t player_grid_radius(const PlayerGrid* grid, Vector2 center, float radius, PeerData** out, size_t max)
+{
+	if (max == 0)
+		return 0;
+
+	GridQuery query = { center.x - radius, center.y - radius, center.x + radius, center.y + radius, &center, radius };
+	GridOut res = { out, NULL };
+	return player_grid_query(grid, &query, &res, max);
+}
+
+size_t player_grid_radius_ex(const PlayerGrid* grid, Vector2 center, float radius, const PlayerGridItem** out, size_t max)
+{
+	if (max == 0)
+		return 0;
+
+	GridQuery query = { center.x - radius, center.y - radius, center.x + radius, center.y + radius, &center, radius };
+	GridOut res = { NULL, out };
+	return player_grid_query(grid, &query, &res, max);
+}
+
+size_t player_grid_rect(const PlayerGrid* grid, float x, float y, float w, float h, PeerData** out, size_t max)
+{
+	if (max == 0)
+		return 0;
+
+	GridQuery query = { x, y, x + w, y + h, NULL, 0 };
+	GridOut res = { out, NULL };
+	return player_grid_query(grid, &query, &res, max);
+}
@@ -0,0 +1,87 @@
+#include <Pool.h>
+#include <stdlib.h>
+
+#define POOL_ALIGN(x) (((x) + 15) & ~(size_t)15)
+#define POOL_HEADER POOL_ALIGN(sizeof(PoolBlock))
+
+void* pool_alloc(Pool* pool, uint8_t cls, size_t size)
+{
+	if (cls >= POOL_CLASSES)
+		return NULL;
+
+	size = POOL_ALIGN(size < sizeof(void*) ? sizeof(void*) : size);
+
+	// Classes keep one size, anything freed at another size can't be reused
+	if (pool->sizes[cls] != size)
+		pool->free[cls] = NULL;
+
+	void* ptr = NULL;
+	if (pool->free[cls])
+	{
+		// Freed object of the same class, next pointer lives in its first bytes
+		ptr = pool->free[cls];
+		pool->free[cls] = *(void**)ptr;
+		pool->reused++;
+	}
+	else
+	{
+		PoolBlock* block = pool->blocks[cls];
+		if (!block || block->used + size > block->size)
+		{
+			size_t bsize = POOL_HEADER + size > POOL_BLOCK_SIZE ? POOL_HEADER + size : POOL_BLOCK_SIZE;
+
+			block = (PoolBlock*)malloc(bsize);
+			if (!block)
+				return NULL;
+
+			block->next = pool->blocks[cls];
+			block->used = POOL_HEADER;
+			block->size = bsize;
+			pool->blocks[cls] = block;
+			pool->reserved += bsize;
+		}
+
+		ptr = (uint8_t*)block + block->used;
+		block->used += size;
+	}
+
+	pool->sizes[cls] = size;
+	pool->bytes += size;
+	pool->live++;
+	pool->allocs++;
+
+	if (pool->bytes > pool->peak_bytes)
+		pool->peak_bytes = pool->bytes;
+
+	return ptr;
+}
+
+void pool_release(Pool* pool, uint8_t cls, void* ptr)
+{
+	if (!ptr || cls >= POOL_CLASSES)
+		return;
+
+	*(void**)ptr = pool->free[cls];
+	pool->free[cls] = ptr;
+	pool->bytes -= pool->sizes[cls];
+	pool->live--;
+}
+
+void pool_reset(Pool* pool)
+{
+	Debug("Match pool: peak %d bytes, %d reserved, %d allocs (%d reused), %d live at end",
+		(int)pool->peak_bytes, (int)pool->reserved, pool->allocs, pool->reused, pool->live);
+
+	for (int i = 0; i < POOL_CLASSES; i++)
+	{
+		PoolBlock* block = pool->blocks[i];
+		while (block)
+		{
+			PoolBlock* next = block->next;
+			free(block);
+			block = next;
+		}
+	}
+
+	memset(pool, 0, sizeof(Pool));
+}
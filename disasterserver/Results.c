@@ -90,10 +90,10 @@ bool results_send(Server* server, PeerData* v, PeerData* data, bool has_quit)
 	if (g_config.pride)
 	{
 		if (data->plr.stats.brain_damage && (data->plr.flags & PLAYER_ESCAPED))
-			postfix = SHAMES_1[rand() % SHAMES1_CNT];
+			postfix = SHAMES_1[rng_range(&server->rng, SHAMES1_CNT)];
 
 		if (data->plr.stats.camp_time >= 30 * TICKSPERSEC)
-			postfix = SHAMES_2[rand() % SHAMES2_CNT];
+			postfix = SHAMES_2[rng_range(&server->rng, SHAMES2_CNT)];
 	}
 
 	nickname.len = snprintf(nickname.value, 129, "%s %s", data->nickname.value, postfix) + 1;
@@ -135,26 +135,12 @@ bool results_init(Server* server)
 
 bool results_uninit(Server* server)
 {
-	for (size_t i = 0; i < server->game.entities.capacity; i++)
-	{
-		Entity* entity = (Entity*)server->game.entities.ptr[i];
-		if (!entity)
-			continue;
-
-		free(entity);
-	}
-	dylist_free(&server->game.entities);
-
-	// Clean up after game
-	for (size_t i = 0; i < server->game.left.capacity; i++)
-	{
-		PeerData* player = (PeerData*)server->game.left.ptr[i];
-		if (!player)
-			continue;
-
-		free(player);
-	}
+	// Clean up after game, entities and left players all live in the pool
+	slotmap_free(&server->game.entities);
 	dylist_free(&server->game.left);
+	free(server->game.despawn);
+	player_grid_free(&server->game.players);
+	pool_reset(&server->game.pool);
 
 	return lobby_init(server);
 }
@@ -169,7 +155,7 @@ bool results_state_tick(Server* server)
 	return true;
 }
 
-bool results_state_handle(PeerData* v, Packet* packet)
+bool results_state_handle(PeerData* v, PacketView* packet)
 {
 	PacketRead(_passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -233,7 +219,7 @@ bool results_state_handle(PeerData* v, Packet* packet)
 
 			Info("[%s] (id %d): %s", v->nickname.value, v->id, msg.value);
 			if (!server_cmd_handle(v->server, server_cmd_parse(&msg), v, &msg))
-				server_broadcast_ex(v->server, packet, true, v->id);
+				server_relay(v->server, packet, true, v->id);
 
 			break;
 		}
@@ -0,0 +1,34 @@
+#include <Rng.h>
+#include <time.h>
+
+static uint64_t rng_splitmix(uint64_t* state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+void rng_seed(Rng* rng, uint64_t seed)
+{
+	uint64_t state = seed;
+	uint64_t a = rng_splitmix(&state);
+	uint64_t b = rng_splitmix(&state);
+
+	rng->s[0] = (uint32_t)a;
+	rng->s[1] = (uint32_t)(a >> 32);
+	rng->s[2] = (uint32_t)b;
+	rng->s[3] = (uint32_t)(b >> 32);
+	rng->seed = seed;
+
+	// All zero state would only ever yield zeros
+	if (!(rng->s[0] | rng->s[1] | rng->s[2] | rng->s[3]))
+		rng->s[0] = 1;
+}
+
+uint64_t rng_entropy(uint64_t salt)
+{
+	// Lobbies starting in the same second still differ by salt and clock
+	uint64_t state = (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32) ^ salt;
+	return rng_splitmix(&state);
+}
@@ -7,6 +7,7 @@
 #include <Log.h>
 #include <States.h>
 #include <Packet.h>
+#include <PeerSet.h>
 #include <ctype.h>
 #include <io/Threads.h>
 #include <io/Time.h>
@@ -19,21 +20,16 @@
 #include <ui/Main.h>
 #endif
 
-cJSON *ip_addr_list = NULL;
-Mutex ip_addr_mut;
-
 bool peer_identity_process(PeerData *v, const char *addr, bool is_banned, uint64_t timeout, bool do_timeout)
 {
-	MutexLock(ip_addr_mut);
+	uint64_t ip_key = peer_set_key_ip(&v->addr);
+	uint64_t udid_key = peer_set_key_udid(v->udid.value);
+
+	if (!v->op && (peer_set_has(ip_key) || peer_set_has(udid_key)))
 	{
-		if (!v->op && (cJSON_HasObjectItem(ip_addr_list, addr) || cJSON_HasObjectItem(ip_addr_list, v->udid.value)))
-		{
-			server_disconnect(v->server, v->peer, DR_IPINUSE, NULL);
-			MutexUnlock(ip_addr_mut);
-			return false;
-		}
+		server_disconnect(v->server, v->peer, DR_IPINUSE, NULL);
+		return false;
 	}
-	MutexUnlock(ip_addr_mut);
 
 	if (is_banned)
 	{
@@ -87,32 +83,41 @@ bool peer_identity_process(PeerData *v, const char *addr, bool is_banned, uint64
 	// If in queue, do following
 	if (!v->in_game)
 	{
-		// For icons
-		for (size_t i = 0; i < v->server->peers.capacity; i++)
+		if (v->ext_proto)
 		{
-			PeerData *peer = (PeerData *)v->server->peers.ptr[i];
-			if (!peer)
-				continue;
+			// Whole roster in one go
+			RAssert(server_roster_snapshot(v->server, &pack, v->id));
+			RAssert(packet_send(v->peer, &pack, true));
+		}
+		else
+		{
+			// For icons
+			for (size_t i = 0; i < v->server->peers.capacity; i++)
+			{
+				PeerData *peer = (PeerData *)v->server->peers.ptr[i];
+				if (!peer)
+					continue;
 
-			if (peer->id == v->id)
-				continue;
+				if (peer->id == v->id)
+					continue;
 
-			PacketCreate(&pack, SERVER_WAITING_PLAYER_INFO);
-			PacketWrite(&pack, packet_write8, v->server->state == ST_GAME && peer->in_game);
-			PacketWrite(&pack, packet_write16, peer->id);
-			PacketWrite(&pack, packet_writestr, peer->nickname);
+				PacketCreate(&pack, SERVER_WAITING_PLAYER_INFO);
+				PacketWrite(&pack, packet_write8, v->server->state == ST_GAME && peer->in_game);
+				PacketWrite(&pack, packet_write16, peer->id);
+				PacketWrite(&pack, packet_writestr, peer->nickname);
 
-			if (v->server->state == ST_GAME && peer->in_game)
-			{
-				PacketWrite(&pack, packet_write8, v->server->game.exe == peer->id);
-				PacketWrite(&pack, packet_write8, v->server->game.exe == peer->id ? peer->exe_char : peer->surv_char);
-			}
-			else
-			{
-				PacketWrite(&pack, packet_write8, peer->lobby_icon);
-			}
+				if (v->server->state == ST_GAME && peer->in_game)
+				{
+					PacketWrite(&pack, packet_write8, v->server->game.exe == peer->id);
+					PacketWrite(&pack, packet_write8, v->server->game.exe == peer->id ? peer->exe_char : peer->surv_char);
+				}
+				else
+				{
+					PacketWrite(&pack, packet_write8, peer->lobby_icon);
+				}
 
-			RAssert(packet_send(v->peer, &pack, true));
+				RAssert(packet_send(v->peer, &pack, true));
+			}
 		}
 
 		// For other players in queue
@@ -121,39 +126,31 @@ bool peer_identity_process(PeerData *v, const char *addr, bool is_banned, uint64
 		PacketWrite(&pack, packet_write16, v->id);
 		PacketWrite(&pack, packet_writestr, v->nickname);
 		PacketWrite(&pack, packet_write8, v->lobby_icon);
-		RAssert(server_broadcast_ex(v->server, &pack, true, v->id));
+		RAssert(server_roster_delta(v->server, v, ROSTER_JOIN, &pack, v->id));
 
-		char msg[100];
-		snprintf(msg, 100, "server " CLRCODE_RED "%d" CLRCODE_RST " of " CLRCODE_BLU "%d" CLRCODE_RST, v->server->id + 1, g_config.server_count);
-
-		server_send_msg(v->server, v->peer, "-----------------------");
-		server_send_msg(v->server, v->peer, CLRCODE_RED "better/server~ v" STRINGIFY(BUILD_VERSION));
-		server_send_msg(v->server, v->peer, "build from " CLRCODE_PUR __DATE__ " " CLRCODE_GRN __TIME__ CLRCODE_RST);
-		server_send_msg(v->server, v->peer, msg);
-		server_send_msg(v->server, v->peer, "-----------------------");
-		server_send_msg(v->server, v->peer, g_config.motd);
+		static const CachedMsg welcome[] = { MSG_LINE, MSG_BANNER, MSG_BUILD, MSG_SERVER, MSG_LINE, MSG_MOTD };
+		server_send_cached(v->server, v->peer, welcome, sizeof(welcome) / sizeof(*welcome));
 
 		if (v->op)
 			server_send_msg(v->server, v->peer, CLRCODE_GRN "you're an operator on this server" CLRCODE_RST);
 
 		if (v->server->state >= ST_GAME)
 		{
+			char msg[100];
 			snprintf(msg, 100, "map: " CLRCODE_GRN "%s" CLRCODE_RST, g_mapList[v->server->game.map].name);
 			server_send_msg(v->server, v->peer, msg);
 		}
 	}
 
-	MutexLock(ip_addr_mut);
-	cJSON_AddItemToObject(ip_addr_list, addr, cJSON_CreateTrue());
-	cJSON_AddItemToObject(ip_addr_list, v->udid.value, cJSON_CreateTrue());
-	MutexUnlock(ip_addr_mut);
+	// A full shard skips the key, removing it later would take another connection's count
+	v->ip_counted = peer_set_add(ip_key);
+	v->udid_counted = peer_set_add(udid_key);
 	return true;
 }
 
-bool peer_identity(PeerData *v, Packet *packet)
+bool peer_identity(PeerData *v, PacketView *packet)
 {
 	RAssert(v->id > 0);
-	srand((unsigned int)time(NULL));
 
 	bool is_banned;
 	uint64_t timeout;
@@ -168,7 +165,7 @@ bool peer_identity(PeerData *v, Packet *packet)
 	PacketRead(lobby_icon, packet, packet_read8, uint8_t);
 	PacketRead(pet, packet, packet_read8, int8_t);
 
-	RAssert(ban_check(udid.value, v->ip.value, &is_banned));
+	RAssert(ban_check(udid.value, &v->addr, &is_banned));
 	RAssert(timeout_check(udid.value, v->ip.value, &timeout));
 	RAssert(op_check(v->ip.value, &v->op));
 
@@ -190,7 +187,7 @@ bool peer_identity(PeerData *v, Packet *packet)
 	MutexLock(v->server->state_lock);
 	{
 		v->in_game = (v->server->state == ST_LOBBY);
-		v->exe_chance = 1 + rand() % 4;
+		v->exe_chance = 1 + rng_range(&v->server->rng, 4);
 
 		if (v->server->peers.noitems >= 7)
 		{
@@ -232,12 +229,13 @@ bool peer_identity(PeerData *v, Packet *packet)
 			goto quit;
 		}
 
-		if (build_version != BUILD_VERSION)
+		if (build_version != BUILD_VERSION && build_version != BUILD_VERSION_EXT)
 		{
 			server_disconnect(v->server, v->peer, DR_VERMISMATCH, NULL);
 			res = false;
 			goto quit;
 		}
+		v->ext_proto = (build_version == BUILD_VERSION_EXT);
 
 		if (string_length(&nickname) >= 30)
 		{
@@ -270,7 +268,7 @@ quit:
 	return res;
 }
 
-bool peer_msg(PeerData *v, Packet *packet)
+bool peer_msg(PeerData *v, PacketView *packet)
 {
 	if (v->id == 0)
 		return false;
@@ -285,130 +283,218 @@ bool peer_msg(PeerData *v, Packet *packet)
 	return res;
 }
 
-bool server_worker(Server *server)
+bool server_event(Server *server, ENetEvent *ev)
 {
-	srand((unsigned int)time(NULL));
-
-	char thread_name[128];
-	snprintf(thread_name, 128, "Worker Thr %d", server->id);
-	ThreadVarSet(g_threadName, thread_name);
+	switch (ev->type)
+	{
+	case ENET_EVENT_TYPE_NONE:
+		break;
 
-	if (!ip_addr_list)
+	case ENET_EVENT_TYPE_CONNECT:
 	{
-		ip_addr_list = cJSON_CreateObject();
-		RAssert(ip_addr_list);
-		MutexCreate(ip_addr_mut);
-	}
+		Debug("ENET_EVENT_TYPE_CONNECT...");
+		ev->peer->data = (PeerData *)malloc(sizeof(PeerData));
+		if (!ev->peer->data)
+			return false;
 
-	TimeStamp ticker;
-	time_start(&ticker);
+		memset(ev->peer->data, 0, sizeof(PeerData));
 
-	double next_tick = time_end(&ticker);
-	double heartbeat = 0.0;
-	const double TARGET_FPS = 1000.0 / 60;
+		PeerData *v = (PeerData *)ev->peer->data;
+		v->server = server;
+		v->peer = ev->peer;
+		v->id = ev->peer->incomingPeerID + 1;
+		enet_address_get_host_ip(&ev->peer->address, v->ip.value, 250);
+		ip_addr_v4(&v->addr, ev->peer->address.host);
 
-	Packet pack;
-	PacketCreate(&pack, SERVER_HEARTBEAT);
+		Packet packet;
+		PacketCreate(&packet, SERVER_PREIDENTITY);
+		RAssert(auth_create_ticket(v, &packet));
+		RAssert(packet_send(ev->peer, &packet, true));
+		break;
+	}
 
-	while (server->running)
+	case ENET_EVENT_TYPE_DISCONNECT:
 	{
-		ENetEvent ev;
-		if (enet_host_service(server->host, &ev, 5) > 0)
+		Debug("ENET_EVENT_TYPE_DISCONNECT...");
+		PeerData *v = (PeerData *)ev->peer->data;
+		if (!v)
+			break;
+
+		if (!v->op && v->should_timeout)
 		{
-			switch (ev.type)
-			{
-			case ENET_EVENT_TYPE_CONNECT:
+			uint64_t result;
+			if (timeout_check(v->udid.value, v->ip.value, &result) && result == 0)
+				timeout_set(v->nickname.value, v->udid.value, v->ip.value, time(NULL) + 5);
+		}
+
+		if (v->udid_counted)
+			peer_set_remove(peer_set_key_udid(v->udid.value));
+
+		if (v->ip_counted)
+			peer_set_remove(peer_set_key_ip(&v->addr));
+
+		if (v->verified)
+		{
+			MutexLock(v->server->state_lock);
 			{
-				Debug("ENET_EVENT_TYPE_CONNECT...");
-				ev.peer->data = (PeerData *)malloc(sizeof(PeerData));
-				if (!ev.peer->data)
-					return false;
-
-				memset(ev.peer->data, 0, sizeof(PeerData));
-
-				PeerData *v = (PeerData *)ev.peer->data;
-				v->server = server;
-				v->peer = ev.peer;
-				v->id = ev.peer->incomingPeerID + 1;
-				enet_address_get_host_ip(&ev.peer->address, v->ip.value, 250);
-
-				Packet packet;
-				PacketCreate(&packet, SERVER_PREIDENTITY);
-				RAssert(auth_create_ticket(v, &packet));
-				RAssert(packet_send(ev.peer, &packet, true));
-				break;
+				// Step 3: Cleanup (Only if joined before)
+				if (dylist_remove(&v->server->peers, v))
+					server_state_left(v);
 			}
+			MutexUnlock(v->server->state_lock);
+		}
 
-			case ENET_EVENT_TYPE_DISCONNECT:
-			{
-				Debug("ENET_EVENT_TYPE_DISCONNECT...");
-				PeerData *v = (PeerData *)ev.peer->data;
-				if (!v)
-					break;
+		Info("%s (id %d) " LOG_YLW "left.", v->nickname.value, v->id);
+		free(v);
+		break;
+	}
 
-				if (!v->op && v->should_timeout)
-				{
-					uint64_t result;
-					if (timeout_check(v->udid.value, v->ip.value, &result) && result == 0)
-						timeout_set(v->nickname.value, v->udid.value, v->ip.value, time(NULL) + 5);
-				}
+	case ENET_EVENT_TYPE_RECEIVE:
+	{
+		PeerData *v = (PeerData *)ev->peer->data;
+		PacketView packet = packet_view(ev->packet);
 
-				if (v->verified)
-				{
-					MutexLock(ip_addr_mut);
-					{
-						cJSON_DeleteItemFromObject(ip_addr_list, v->udid.value);
-						cJSON_DeleteItemFromObject(ip_addr_list, v->ip.value);
-					}
-					MutexUnlock(ip_addr_mut);
+		if (packet.len < 2)
+		{
+			enet_packet_destroy(ev->packet);
+			break;
+		}
 
-					MutexLock(v->server->state_lock);
-					{
-						// Step 3: Cleanup (Only if joined before)
-						if (dylist_remove(&v->server->peers, v))
-							server_state_left(v);
-					}
-					MutexUnlock(v->server->state_lock);
-				}
+		// Hold our own reference so disconnects during relaying can't free it
+		ev->packet->referenceCount++;
 
-				Info("%s (id %d) " LOG_YLW "left.", v->nickname.value, v->id);
-				free(v);
-				break;
+		switch (packet.data[1])
+		{
+		case IDENTITY:
+		{
+			if (!peer_identity(v, &packet))
+			{
+				Debug("Identity failed for id %d", v->id);
 			}
+			break;
+		}
+		default:
+		{
+			if (!peer_msg(v, &packet))
+				break;
+		}
+		}
 
-			case ENET_EVENT_TYPE_RECEIVE:
-			{
-				PeerData *v = (PeerData *)ev.peer->data;
-				Packet packet = packet_from(ev.packet);
+		// Relayed packets are owned by ENet until sent
+		if (--ev->packet->referenceCount == 0)
+			enet_packet_destroy(ev->packet);
 
-				switch (packet.buff[1])
-				{
-				case IDENTITY:
-				{
-					if (!peer_identity(v, &packet))
-					{
-						Debug("Identity failed for id %d", v->id);
-					}
-					break;
-				}
-				default:
-				{
-					if (!peer_msg(v, &packet))
-						break;
-				}
-				}
+		break;
+	}
+	}
 
-				break;
-			}
-			}
+	return true;
+}
+
+size_t server_pending_events(Server *server)
+{
+	size_t count = 0;
+
+	// Every peer with something to dispatch sits in the host's dispatch queue
+	ENetList *queue = &server->host->dispatchQueue;
+	for (ENetListIterator it = enet_list_begin(queue); it != enet_list_end(queue); it = enet_list_next(it))
+	{
+		ENetPeer *peer = (ENetPeer *)it;
+		count += enet_list_size(&peer->dispatchedCommands);
+
+		// Pending connect or disconnect notification
+		if (peer->state == ENET_PEER_STATE_CONNECTION_SUCCEEDED || peer->state == ENET_PEER_STATE_ZOMBIE)
+			count++;
+	}
+
+	return count;
+}
+
+bool server_receive(Server *server)
+{
+	ENetEvent ev;
+	uint32_t handled = 0;
+
+	// Wait for the first event, then drain whatever else is already queued
+	int res = enet_host_service(server->host, &ev, 5);
+	while (res > 0)
+	{
+		RAssert(server_event(server, &ev));
+
+		if (++handled >= RECV_BUDGET)
+			break;
+
+		res = enet_host_check_events(server->host, &ev);
+	}
+
+	// Socket errors (WSAECONNRESET after an ICMP port-unreachable on Windows) only cost this pass
+	if (res < 0)
+		Debug("enet_host_service failed (%d), continuing", res);
+
+	size_t left = server_pending_events(server);
+	if (handled >= RECV_BUDGET && left > 0)
+	{
+		server->net.deferred += left;
+		Debug("Receive budget hit, %d event(s) deferred", (int)left);
+	}
+
+	server->net.backlog = (uint32_t)left;
+	if (server->net.backlog > server->net.backlog_peak)
+		server->net.backlog_peak = server->net.backlog;
+
+	return true;
+}
+
+bool server_worker(Server *server)
+{
+	char thread_name[128];
+	snprintf(thread_name, 128, "Worker Thr %d", server->id);
+	ThreadVarSet(g_threadName, thread_name);
+
+	if (g_config.rng_seed)
+		rng_seed(&server->rng, (uint64_t)g_config.rng_seed + server->id);
+	else
+		rng_seed(&server->rng, rng_entropy((uintptr_t)server ^ server->id));
+	Debug("Lobby seed: %llu", (unsigned long long)server->rng.seed);
+
+	// Tickets must stay unpredictable and joins must not shift the gameplay stream a fixed seed replays
+	rng_seed(&server->auth_rng, rng_entropy((uintptr_t)&server->auth_rng ^ ((uint64_t)server->id << 48)));
+
+	TimeStamp ticker;
+	time_start(&ticker);
+
+	double next_tick = time_end(&ticker);
+	double heartbeat = 0.0;
+	const double TARGET_FPS = 1000.0 / 60;
+
+	Packet pack;
+	PacketCreate(&pack, SERVER_HEARTBEAT);
+	RAssert(packet_arena_init(&server->arena));
+	RAssert(server_msgcache_build(server));
+
+	while (server->running)
+	{
+		// Nothing built last iteration outlives it
+		packet_arena_reset(&server->arena);
+
+		if (!server_receive(server))
+		{
+			server_msgcache_free(server);
+			packet_arena_free(&server->arena);
+			return false;
 		}
 
+		server_flush_bundles(server);
+
 		double now = time_end(&ticker);
+		bool ticked = next_tick < now;
 		while (next_tick < now)
 		{
 			next_tick += TARGET_FPS;
 			MutexLock(server->state_lock);
 			{
+				uint64_t allocs_saved = server->net.allocs_saved;
+
 				switch (server->state)
 				{
 				case ST_LOBBY:
@@ -429,24 +515,89 @@ bool server_worker(Server *server)
 				// Heartbeat
 				if (server->peers.noitems > 0)
 				{
-					server_broadcast(server, &pack, true);
+					server_heartbeat(server, &pack);
 					if (heartbeat >= (TICKSPERSEC * 2))
 					{
-						Debug("Heartbeat done.");
+						Debug("Heartbeat done. (backlog %d, peak %d, deferred %d, allocs saved %d/tick, %d msgs in %d bundles)", server->net.backlog, server->net.backlog_peak, (int)server->net.deferred, server->net.tick_allocs_saved, (int)server->net.bundled, (int)server->net.bundles);
+						Debug("Heartbeats: %d sent, %d avoided", (int)server->net.heartbeats, (int)server->net.heartbeats_avoided);
+						Debug("Tick-to-wire: <0.25ms %d, <0.5ms %d, <1ms %d, <2ms %d, <4ms %d, <8ms %d, <16ms %d, more %d",
+							server->net.wire_hist[0], server->net.wire_hist[1], server->net.wire_hist[2], server->net.wire_hist[3],
+							server->net.wire_hist[4], server->net.wire_hist[5], server->net.wire_hist[6], server->net.wire_hist[7]);
 						heartbeat = 0;
 					}
 					heartbeat += server->delta;
 				}
+
+				server->net.tick_allocs_saved = (uint32_t)(server->net.allocs_saved - allocs_saved);
 			}
 			MutexUnlock(server->state_lock);
 			server->delta = 1;
 		}
+
+		// Push the tick's output to the wire now instead of on the next service call
+		if (ticked)
+		{
+			server_flush_bundles(server);
+			enet_host_flush(server->host);
+			server_wire_latency(server, time_end(&ticker) - now);
+		}
 	}
 
+	server_msgcache_free(server);
+	packet_arena_free(&server->arena);
 	enet_host_destroy(server->host);
 	return true;
 }
 
+void server_heartbeat(Server *server, Packet *pack)
+{
+	double interval = g_config.heartbeat_interval * TICKSPERSEC / 1000.0;
+
+	for (size_t i = 0; i < server->peers.capacity; i++)
+	{
+		PeerData *v = (PeerData *)server->peers.ptr[i];
+		if (!v)
+			continue;
+
+		if (v->disconnecting)
+			continue;
+
+		// Anything sent recently already tells the client we're alive
+		v->idle += server->delta;
+		if (v->idle < interval)
+		{
+			server->net.heartbeats_avoided++;
+			continue;
+		}
+
+		// Same for reliable data that is still queued or waiting for an ack
+		if (!enet_list_empty(&v->peer->outgoingSendReliableCommands) || !enet_list_empty(&v->peer->sentReliableCommands))
+		{
+			server->net.heartbeats_avoided++;
+			continue;
+		}
+
+		if (!packet_send(v->peer, pack, true))
+			server_disconnect(server, v->peer, DR_SERVERTIMEOUT, NULL);
+
+		server->net.heartbeats++;
+	}
+}
+
+void server_wire_latency(Server *server, double ms)
+{
+	// Buckets: 0.25, 0.5, 1, 2, 4, 8, 16 ms and everything above
+	int bucket = 0;
+	double limit = 0.25;
+	while (bucket < WIRE_HIST_BUCKETS - 1 && ms >= limit)
+	{
+		limit *= 2;
+		bucket++;
+	}
+
+	server->net.wire_hist[bucket]++;
+}
+
 bool server_disconnect(Server *server, ENetPeer *peer, DisconnectReason reason, const char *text)
 {
 	if (server)
@@ -554,21 +705,98 @@ PeerData *server_find_peer(Server *server, uint16_t id)
 
 bool server_broadcast(Server *server, Packet *packet, bool reliable)
 {
+	// Peer ids start at 1, so nobody is skipped
+	return server_broadcast_ex(server, packet, reliable, 0);
+}
+
+bool server_broadcast_ex(Server *server, Packet *packet, bool reliable, uint16_t ignore)
+{
+	// Build the packet once, every peer just holds a reference to it
+	ENetPacket *shared = packet_build(packet, reliable);
+	RAssert(shared);
+
+	bool res = server_broadcast_raw(server, shared, reliable, ignore);
+	if (shared->referenceCount == 0)
+		enet_packet_destroy(shared);
+
+	return res;
+}
+
+bool server_broadcast_raw(Server *server, ENetPacket *shared, bool reliable, uint16_t ignore)
+{
+	uint32_t sent = 0;
 	for (size_t i = 0; i < server->peers.capacity; i++)
 	{
 		PeerData *v = (PeerData *)server->peers.ptr[i];
 		if (!v)
 			continue;
 
-		if (!packet_send(v->peer, packet, reliable))
+		if (v->id == ignore)
+			continue;
+
+		if (v->disconnecting)
+			continue;
+
+		v->idle = 0;
+		if (v->ext_proto)
+		{
+			if (!packet_bundle_append(v, shared->data, shared->dataLength, reliable))
+				server_disconnect(server, v->peer, DR_SERVERTIMEOUT, NULL);
+
+			continue;
+		}
+
+		if (enet_peer_send(v->peer, reliable ? 0 : 1, shared) != 0)
 			server_disconnect(server, v->peer, DR_SERVERTIMEOUT, NULL);
+		else
+			sent++;
 	}
 
+	if (sent > 1)
+		server->net.allocs_saved += sent - 1;
+
 	return true;
 }
 
-bool server_broadcast_ex(Server *server, Packet *packet, bool reliable, uint16_t ignore)
+bool server_relay(Server *server, PacketView *packet, bool reliable, uint16_t ignore)
+{
+	ENetPacket *source = packet->source;
+
+	// Already queued with different flags, fall back to a copy
+	if (source->referenceCount > 1 && ((source->flags & ENET_PACKET_FLAG_RELIABLE) != 0) != reliable)
+	{
+		ENetPacket *copy = enet_packet_create(source->data, source->dataLength, reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
+		RAssert(copy);
+
+		bool res = server_broadcast_raw(server, copy, reliable, ignore);
+		if (copy->referenceCount == 0)
+			enet_packet_destroy(copy);
+
+		return res;
+	}
+
+	// Hand the received buffer itself to everyone, the worker frees it once unreferenced
+	source->flags = reliable ? ENET_PACKET_FLAG_RELIABLE : 0;
+	return server_broadcast_raw(server, source, reliable, ignore);
+}
+
+bool server_relay_from(Server *server, PacketView *packet, bool reliable, uint16_t sender)
+{
+	// The view is read again after relaying (map callbacks), so copy instead of rewriting it in place
+	RAssert(packet->len >= 2);
+
+	Packet pack;
+	PacketCreate(&pack, packet->data[1]);
+	PacketWrite(&pack, packet_write16, sender);
+	RAssert(packet_writeblob(&pack, &packet->data[2], packet->len - 2));
+
+	return server_broadcast_ex(server, &pack, reliable, sender);
+}
+
+bool server_broadcast_split(Server *server, Packet *legacy, Packet *ext, bool reliable, uint16_t ignore)
 {
+	ENetPacket *shared = NULL;
+
 	for (size_t i = 0; i < server->peers.capacity; i++)
 	{
 		PeerData *v = (PeerData *)server->peers.ptr[i];
@@ -578,13 +806,98 @@ bool server_broadcast_ex(Server *server, Packet *packet, bool reliable, uint16_t
 		if (v->id == ignore)
 			continue;
 
-		if (!packet_send(v->peer, packet, reliable))
+		if (v->disconnecting)
+			continue;
+
+		if (v->ext_proto)
+		{
+			if (!packet_send(v->peer, ext, reliable))
+				server_disconnect(server, v->peer, DR_SERVERTIMEOUT, NULL);
+
+			continue;
+		}
+
+		if (!legacy)
+			continue;
+
+		if (!shared)
+		{
+			shared = packet_build(legacy, reliable);
+			RAssert(shared);
+		}
+
+		v->idle = 0;
+		if (enet_peer_send(v->peer, reliable ? 0 : 1, shared) != 0)
 			server_disconnect(server, v->peer, DR_SERVERTIMEOUT, NULL);
 	}
 
+	if (shared && shared->referenceCount == 0)
+		enet_packet_destroy(shared);
+
 	return true;
 }
 
+bool server_roster_entry(Server *server, Packet *pack, PeerData *peer)
+{
+	int exe = server->state == ST_GAME ? server->game.exe : server->lobby.exe;
+
+	uint8_t flags = 0;
+	if (peer->in_game)
+		flags |= ROSTER_IN_GAME;
+
+	if (peer->id == exe)
+		flags |= ROSTER_EXE;
+
+	PacketWrite(pack, packet_write16, peer->id);
+	PacketWrite(pack, packet_write8, flags);
+	PacketWrite(pack, packet_write8, peer->lobby_icon);
+	PacketWrite(pack, packet_write8, (flags & ROSTER_EXE) ? (uint8_t)peer->exe_char : (uint8_t)peer->surv_char);
+	PacketWrite(pack, packet_writestr, peer->nickname);
+	return true;
+}
+
+bool server_roster_snapshot(Server *server, Packet *pack, uint16_t ignore)
+{
+	PacketCreate(pack, SERVER_ROSTER_SNAPSHOT);
+	PacketWrite(pack, packet_write8, 0);
+
+	uint8_t count = 0;
+	for (size_t i = 0; i < server->peers.capacity; i++)
+	{
+		PeerData *peer = (PeerData *)server->peers.ptr[i];
+		if (!peer)
+			continue;
+
+		if (peer->id == ignore)
+			continue;
+
+		RAssert(server_roster_entry(server, pack, peer));
+		count++;
+	}
+
+	// Count goes right after the header
+	packet_data(pack)[2] = count;
+	return true;
+}
+
+bool server_roster_delta(Server *server, PeerData *v, RosterOp op, Packet *legacy, uint16_t ignore)
+{
+	Packet pack;
+	PacketCreate(&pack, SERVER_ROSTER_DELTA);
+	PacketWrite(&pack, packet_write8, (uint8_t)op);
+
+	if (op == ROSTER_LEAVE)
+	{
+		PacketWrite(&pack, packet_write16, v->id);
+	}
+	else
+	{
+		RAssert(server_roster_entry(server, &pack, v));
+	}
+
+	return server_broadcast_split(server, legacy, &pack, true, ignore);
+}
+
 bool server_state_joined(PeerData *v)
 {
 #ifdef SYS_USE_SDL2
@@ -620,7 +933,7 @@ bool server_state_joined(PeerData *v)
 	return true;
 }
 
-bool server_state_handle(PeerData *v, Packet *packet)
+bool server_state_handle(PeerData *v, PacketView *packet)
 {
 	switch (v->server->state)
 	{
@@ -648,7 +961,7 @@ bool server_state_left(PeerData *v)
 	Packet pack;
 	PacketCreate(&pack, SERVER_PLAYER_LEFT);
 	PacketWrite(&pack, packet_write16, v->id);
-	server_broadcast(v->server, &pack, true);
+	server_roster_delta(v->server, v, ROSTER_LEAVE, &pack, 0);
 
 	switch (v->server->state)
 	{
@@ -800,23 +1113,13 @@ bool server_cmd_handle(Server *server, unsigned long hash, PeerData *v, String *
 	/* Help message  */
 	case CMD_HELP:
 	{
-		char lobby_msg[128];
-		snprintf(lobby_msg, 128, CLRCODE_GRA ".lobby" CLRCODE_RST " choose lobby (1-%d)", disaster_count());
+		static const CachedMsg help[] = { MSG_HELP_INFO, MSG_HELP_LOBBY, MSG_HELP_VK, MSG_HELP_VP };
+		static const CachedMsg help_op[] = { MSG_HELP_MAP, MSG_HELP_KICK, MSG_HELP_BAN, MSG_HELP_OP };
 
-		RAssert(server_send_msg(v->server, v->peer, CLRCODE_GRA ".info" CLRCODE_RST " server info"));
-		RAssert(server_send_msg(v->server, v->peer, lobby_msg));
-		RAssert(server_send_msg(v->server, v->peer, CLRCODE_GRA ".vk" CLRCODE_RST " vote kick"));
-		RAssert(server_send_msg(v->server, v->peer, CLRCODE_GRA ".vp" CLRCODE_RST " vote practice mode"));
+		RAssert(server_send_cached(v->server, v->peer, help, sizeof(help) / sizeof(*help)));
 
 		if (v->op)
-		{
-			snprintf(lobby_msg, 128, CLRCODE_GRA CLRCODE_GRA ".map" CLRCODE_RST " choose map (1-%d)", MAP_COUNT + 1);
-			RAssert(server_send_msg(v->server, v->peer, lobby_msg));
-
-			RAssert(server_send_msg(v->server, v->peer, CLRCODE_GRA ".kick" CLRCODE_RST " kick someone ig"));
-			RAssert(server_send_msg(v->server, v->peer, CLRCODE_GRA ".ban" CLRCODE_RST " ban someone ig"));
-			RAssert(server_send_msg(v->server, v->peer, CLRCODE_GRA ".op" CLRCODE_RST " op someone ig"));
-		}
+			RAssert(server_send_cached(v->server, v->peer, help_op, sizeof(help_op) / sizeof(*help_op)));
 
 		break;
 	}
@@ -824,16 +1127,8 @@ bool server_cmd_handle(Server *server, unsigned long hash, PeerData *v, String *
 	/* Information about the lobby */
 	case CMD_INFO:
 	{
-		char msg[100];
-		snprintf(msg, 100, "server " CLRCODE_RED "%d" CLRCODE_RST " of " CLRCODE_BLU "%d" CLRCODE_RST, v->server->id + 1, g_config.server_count);
-
-		server_send_msg(v->server, v->peer, "-----------------------");
-		server_send_msg(v->server, v->peer, CLRCODE_RED "better" CLRCODE_BLU "server" CLRCODE_RST " v" STRINGIFY(BUILD_VERSION));
-		server_send_msg(v->server, v->peer, "build from " CLRCODE_PUR __DATE__ " " CLRCODE_GRN __TIME__ CLRCODE_RST);
-		server_send_msg(v->server, v->peer, msg);
-		server_send_msg(v->server, v->peer, "-----------------------");
-		server_send_msg(v->server, v->peer, CLRCODE_GRA "type .help for command list" CLRCODE_RST);
-		server_send_msg(v->server, v->peer, g_config.motd);
+		static const CachedMsg info[] = { MSG_LINE, MSG_BANNER_INFO, MSG_BUILD, MSG_SERVER, MSG_LINE, MSG_HELP_HINT_INFO, MSG_MOTD };
+		server_send_cached(v->server, v->peer, info, sizeof(info) / sizeof(*info));
 		break;
 	}
 
@@ -858,7 +1153,7 @@ bool server_cmd_handle(Server *server, unsigned long hash, PeerData *v, String *
 	return true;
 }
 
-bool server_msg_handle(Server *server, PacketType type, PeerData *v, Packet *packet)
+bool server_msg_handle(Server *server, PacketType type, PeerData *v, PacketView *packet)
 {
 	switch (type)
 	{
@@ -961,3 +1256,124 @@ bool server_broadcast_msg(Server *server, const char *message)
 	server_broadcast(server, &pack, true);
 	return true;
 }
+
+bool server_msgcache_set(Server *server, CachedMsg msg, const char *message)
+{
+	Packet pack;
+	PacketCreate(&pack, CLIENT_CHAT_MESSAGE);
+	PacketWrite(&pack, packet_write16, 0);
+	PacketWrite(&pack, packet_writestr, string_lower(__Str(message)));
+
+	ENetPacket *packet = packet_build(&pack, true);
+	RAssert(packet);
+
+	// Keep our own reference so ENet never frees it after sending
+	packet->referenceCount++;
+
+	ENetPacket *old = server->msgs.packets[msg];
+	if (old && --old->referenceCount == 0)
+		enet_packet_destroy(old);
+
+	server->msgs.packets[msg] = packet;
+	return true;
+}
+
+bool server_msgcache_build(Server *server)
+{
+	char msg[128];
+
+	RAssert(server_msgcache_set(server, MSG_LINE, "-----------------------"));
+	RAssert(server_msgcache_set(server, MSG_BANNER, CLRCODE_RED "better/server~ v" STRINGIFY(BUILD_VERSION)));
+	RAssert(server_msgcache_set(server, MSG_BANNER_INFO, CLRCODE_RED "better" CLRCODE_BLU "server" CLRCODE_RST " v" STRINGIFY(BUILD_VERSION)));
+	RAssert(server_msgcache_set(server, MSG_BUILD, "build from " CLRCODE_PUR __DATE__ " " CLRCODE_GRN __TIME__ CLRCODE_RST));
+
+	snprintf(msg, 128, "server " CLRCODE_RED "%d" CLRCODE_RST " of " CLRCODE_BLU "%d" CLRCODE_RST, server->id + 1, g_config.server_count);
+	RAssert(server_msgcache_set(server, MSG_SERVER, msg));
+
+	RAssert(server_msgcache_set(server, MSG_HELP_HINT, CLRCODE_GRA "type .help for command list~"));
+	RAssert(server_msgcache_set(server, MSG_HELP_HINT_INFO, CLRCODE_GRA "type .help for command list" CLRCODE_RST));
+
+	snprintf(server->msgs.motd, 256, "%s", g_config.motd);
+	RAssert(server_msgcache_set(server, MSG_MOTD, server->msgs.motd));
+
+	snprintf(msg, 128, CLRCODE_GRA ".lobby" CLRCODE_RST " choose lobby (1-%d)", disaster_count());
+	RAssert(server_msgcache_set(server, MSG_HELP_INFO, CLRCODE_GRA ".info" CLRCODE_RST " server info"));
+	RAssert(server_msgcache_set(server, MSG_HELP_LOBBY, msg));
+	RAssert(server_msgcache_set(server, MSG_HELP_VK, CLRCODE_GRA ".vk" CLRCODE_RST " vote kick"));
+	RAssert(server_msgcache_set(server, MSG_HELP_VP, CLRCODE_GRA ".vp" CLRCODE_RST " vote practice mode"));
+
+	snprintf(msg, 128, CLRCODE_GRA CLRCODE_GRA ".map" CLRCODE_RST " choose map (1-%d)", MAP_COUNT + 1);
+	RAssert(server_msgcache_set(server, MSG_HELP_MAP, msg));
+	RAssert(server_msgcache_set(server, MSG_HELP_KICK, CLRCODE_GRA ".kick" CLRCODE_RST " kick someone ig"));
+	RAssert(server_msgcache_set(server, MSG_HELP_BAN, CLRCODE_GRA ".ban" CLRCODE_RST " ban someone ig"));
+	RAssert(server_msgcache_set(server, MSG_HELP_OP, CLRCODE_GRA ".op" CLRCODE_RST " op someone ig"));
+
+	return true;
+}
+
+void server_msgcache_free(Server *server)
+{
+	for (int i = 0; i < MSG_COUNT; i++)
+	{
+		ENetPacket *packet = server->msgs.packets[i];
+		if (packet && --packet->referenceCount == 0)
+			enet_packet_destroy(packet);
+
+		server->msgs.packets[i] = NULL;
+	}
+}
+
+bool server_send_cached(Server *server, ENetPeer *peer, const CachedMsg *list, size_t count)
+{
+	PeerData *v = (PeerData *)peer->data;
+	if (v && v->disconnecting)
+		return true;
+
+	// Motd can be edited while running
+	if (strcmp(server->msgs.motd, g_config.motd) != 0)
+	{
+		snprintf(server->msgs.motd, 256, "%s", g_config.motd);
+		RAssert(server_msgcache_set(server, MSG_MOTD, server->msgs.motd));
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		ENetPacket *packet = server->msgs.packets[list[i]];
+		RAssert(packet);
+
+		if (v && v->ext_proto)
+		{
+			RAssert(packet_bundle_append(v, packet->data, packet->dataLength, true));
+		}
+		else
+		{
+			RAssert(enet_peer_send(peer, 0, packet) == 0);
+		}
+	}
+
+	if (v)
+		v->idle = 0;
+
+	return true;
+}
+
+bool server_flush_bundles(Server *server)
+{
+	bool res = true;
+
+	MutexLock(server->state_lock);
+	{
+		for (size_t i = 0; i < server->peers.capacity; i++)
+		{
+			PeerData *v = (PeerData *)server->peers.ptr[i];
+			if (!v || !v->ext_proto)
+				continue;
+
+			if (!packet_bundle_flush(v))
+				res = false;
+		}
+	}
+	MutexUnlock(server->state_lock);
+
+	return res;
+}
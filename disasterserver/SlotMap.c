@@ -0,0 +1,114 @@
+#include <SlotMap.h>
+#include <stdlib.h>
+
+#define SLOT(id) (((id) & SLOTMAP_SLOT_MASK) - 1)
+#define GEN(id) ((id) >> SLOTMAP_SLOT_BITS)
+
+bool slotmap_create(SlotMap* map, size_t max_capacity)
+{
+	if (!map)
+		return false;
+
+	RAssert(max_capacity > 0 && max_capacity <= SLOTMAP_MAX);
+
+	memset(map, 0, sizeof(SlotMap));
+	map->capacity = max_capacity;
+	map->items = (void**)malloc(max_capacity * sizeof(void*));
+	map->ids = (uint16_t*)malloc(max_capacity * sizeof(uint16_t));
+	map->dense = (uint16_t*)malloc(max_capacity * sizeof(uint16_t));
+	map->gens = (uint8_t*)calloc(max_capacity, sizeof(uint8_t));
+	map->free = (uint16_t*)malloc(max_capacity * sizeof(uint16_t));
+
+	if (!map->items || !map->ids || !map->dense || !map->gens || !map->free)
+	{
+		slotmap_free(map);
+		return false;
+	}
+
+	for (size_t i = 0; i < max_capacity; i++)
+		map->free[i] = (uint16_t)i;
+
+	map->free_count = max_capacity;
+	Debug("%p SlotMap allocated (%d slots)", map->items, max_capacity);
+	return true;
+}
+
+uint16_t slotmap_insert(SlotMap* map, void* item)
+{
+	if (!map || !item)
+		return 0;
+
+	if (map->free_count == 0)
+	{
+		Warn("%p SlotMap reached limit (%d items)!", map->items, map->capacity);
+		return 0;
+	}
+
+	uint16_t slot = map->free[map->free_head];
+	map->free_head = (map->free_head + 1) % map->capacity;
+	map->free_count--;
+
+	uint16_t id = (uint16_t)((map->gens[slot] << SLOTMAP_SLOT_BITS) | (slot + 1));
+	map->dense[slot] = (uint16_t)map->noitems;
+	map->items[map->noitems] = item;
+	map->ids[map->noitems] = id;
+	map->noitems++;
+
+	return id;
+}
+
+void* slotmap_get(SlotMap* map, uint16_t id)
+{
+	uint16_t slot = SLOT(id);
+	if (id == 0 || slot >= map->capacity)
+		return NULL;
+
+	// Stale id from an earlier occupant of the slot
+	if (map->gens[slot] != GEN(id))
+		return NULL;
+
+	uint16_t index = map->dense[slot];
+	if (index >= map->noitems || map->ids[index] != id)
+		return NULL;
+
+	return map->items[index];
+}
+
+void* slotmap_remove(SlotMap* map, uint16_t id)
+{
+	void* item = slotmap_get(map, id);
+	if (!item)
+		return NULL;
+
+	uint16_t slot = SLOT(id);
+	uint16_t index = map->dense[slot];
+
+	// Move the last item into the hole to stay packed
+	size_t last = --map->noitems;
+	if (index != last)
+	{
+		map->items[index] = map->items[last];
+		map->ids[index] = map->ids[last];
+		map->dense[SLOT(map->ids[index])] = index;
+	}
+
+	map->gens[slot] = (map->gens[slot] + 1) & 0xF;
+	map->free[(map->free_head + map->free_count) % map->capacity] = slot;
+	map->free_count++;
+
+	return item;
+}
+
+void slotmap_free(SlotMap* map)
+{
+	if (!map)
+		return;
+
+	Debug("%p SlotMap freed.", map->items);
+	free(map->items);
+	free(map->ids);
+	free(map->dense);
+	free(map->gens);
+	free(map->free);
+	memset(map, 0, sizeof(SlotMap));
+}
@@ -0,0 +1,63 @@
+#include <MapData.h>
+
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(Vector2))
+
+static const Vector2 spawn_tdoll[] =
+{
+	{ 177, 944 },
+	{ 1953, 544 },
+	{ 3279, 224 },
+	{ 4101, 544 },
+	{ 4060, 1264 },
+	{ 3805, 1824 },
+	{ 2562, 1584 },
+	{ 515,  1824 },
+	{ 2115, 1056 },
+	{ 984,  1184 },
+	{ 1498, 1504 }
+};
+
+static const Vector2 spawn_rmz_slug[] =
+{
+	{ 1901, 392 },
+	{ 2193, 392 },
+	{ 2468, 392 },
+	{ 1188, 860 },
+	{ 2577, 1952 },
+	{ 2564, 2264 },
+	{ 2782, 2264 },
+	{ 1441, 2264 },
+	{ 884, 2264 },
+	{ 988, 2004 },
+	{ 915, 2004 }
+};
+
+static const Vector2 spawn_rmz_shard[] =
+{
+	{ 862, 248 },
+	{ 3078, 248 },
+	{ 292, 558 },
+	{ 2918, 558 },
+	{ 1100, 820 },
+	{ 980, 1188 },
+	{ 1870, 1252 },
+	{ 2180, 1508 },
+	{ 2920, 2216 },
+	{ 282, 2228 },
+	{ 1318, 1916 },
+	{ 3010, 1766 }
+};
+
+const Vector2* g_spawnTable[SPAWN_COUNT] =
+{
+	spawn_tdoll,
+	spawn_rmz_slug,
+	spawn_rmz_shard
+};
+
+size_t g_spawnTableSize[SPAWN_COUNT] =
+{
+	ARRAY_SIZE(spawn_tdoll),
+	ARRAY_SIZE(spawn_rmz_slug),
+	ARRAY_SIZE(spawn_rmz_shard)
+};
@@ -0,0 +1,594 @@
+#include <Store.h>
+#include <Persist.h>
+#include <Config.h>
+#include <Log.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+	#include <io.h>
+	#define store_sync(file) _commit(_fileno(file))
+#else
+	#include <unistd.h>
+	#define store_sync(file) fsync(fileno(file))
+#endif
+
+#define STORE_MIN_CAPACITY	64
+#define STORE_MAX_STRING	1024	/* Longest key or nickname a journal record holds */
+
+static uint64_t store_hash(const char* key)
+{
+	// FNV-1a over lowercase, keys match case-insensitively like the cJSON lookups did
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (; *key; key++)
+	{
+		hash ^= (uint8_t)tolower((unsigned char)*key);
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash ? hash : 1;
+}
+
+static bool store_keyeq(const char* a, const char* b)
+{
+	for (; *a && *b; a++, b++)
+	{
+		if (tolower((unsigned char)*a) != tolower((unsigned char)*b))
+			return false;
+	}
+
+	return *a == *b;
+}
+
+static StoreEntry* store_find(Store* store, const char* key, uint64_t hash, StoreEntry** insert)
+{
+	size_t mask = store->capacity - 1;
+	StoreEntry* tomb = NULL;
+
+	for (size_t i = hash & mask;; i = (i + 1) & mask)
+	{
+		StoreEntry* slot = &store->slots[i];
+		if (!slot->hash)
+		{
+			if (insert)
+				*insert = tomb ? tomb : slot;
+
+			return NULL;
+		}
+
+		if (!slot->item)
+		{
+			if (!tomb)
+				tomb = slot;
+
+			continue;
+		}
+
+		if (slot->hash == hash && store_keyeq(slot->item->string, key))
+			return slot;
+	}
+}
+
+static void store_heap_set(Store* store, size_t i, StoreEntry* entry)
+{
+	store->heap[i] = entry;
+	entry->heap = i;
+}
+
+static void store_heap_up(Store* store, size_t i)
+{
+	StoreEntry* entry = store->heap[i];
+	while (i > 0)
+	{
+		size_t parent = (i - 1) / 2;
+		if (store->heap[parent]->value <= entry->value)
+			break;
+
+		store_heap_set(store, i, store->heap[parent]);
+		i = parent;
+	}
+
+	store_heap_set(store, i, entry);
+}
+
+static void store_heap_down(Store* store, size_t i)
+{
+	StoreEntry* entry = store->heap[i];
+	while (true)
+	{
+		size_t child = i * 2 + 1;
+		if (child >= store->heap_count)
+			break;
+
+		if (child + 1 < store->heap_count && store->heap[child + 1]->value < store->heap[child]->value)
+			child++;
+
+		if (entry->value <= store->heap[child]->value)
+			break;
+
+		store_heap_set(store, i, store->heap[child]);
+		i = child;
+	}
+
+	store_heap_set(store, i, entry);
+}
+
+static bool store_heap_push(Store* store, StoreEntry* entry)
+{
+	if (store->heap_count >= store->heap_capacity)
+	{
+		size_t capacity = store->heap_capacity ? store->heap_capacity * 2 : STORE_MIN_CAPACITY;
+		StoreEntry** heap = (StoreEntry**)realloc(store->heap, capacity * sizeof(StoreEntry*));
+		RAssert(heap);
+
+		store->heap = heap;
+		store->heap_capacity = capacity;
+	}
+
+	store_heap_set(store, store->heap_count++, entry);
+	store_heap_up(store, entry->heap);
+	return true;
+}
+
+static void store_heap_remove(Store* store, StoreEntry* entry)
+{
+	size_t i = entry->heap;
+	StoreEntry* last = store->heap[--store->heap_count];
+	if (last == entry)
+		return;
+
+	store_heap_set(store, i, last);
+	store_heap_up(store, i);
+	store_heap_down(store, last->heap);
+}
+
+static bool store_resize(Store* store, size_t min_count)
+{
+	size_t capacity = STORE_MIN_CAPACITY;
+	while (capacity * 3 < min_count * 4 + 4)
+		capacity *= 2;
+
+	StoreEntry* old = store->slots;
+	size_t old_capacity = store->capacity;
+
+	store->slots = (StoreEntry*)calloc(capacity, sizeof(StoreEntry));
+	if (!store->slots)
+	{
+		store->slots = old;
+		return false;
+	}
+
+	store->capacity = capacity;
+	store->removed = 0;
+
+	// Reinsert live entries, tombstones are dropped
+	for (size_t i = 0; i < old_capacity; i++)
+	{
+		if (!old[i].item)
+			continue;
+
+		StoreEntry* slot;
+		store_find(store, old[i].item->string, old[i].hash, &slot);
+		*slot = old[i];
+
+		if (store->timed)
+			store->heap[slot->heap] = slot;
+	}
+
+	free(old);
+	return true;
+}
+
+static void store_evict(Store* store, StoreEntry* entry)
+{
+	if (store->timed)
+		store_heap_remove(store, entry);
+
+	cJSON_Delete(cJSON_DetachItemViaPointer(store->root, entry->item));
+	entry->item = NULL;
+	store->count--;
+	store->removed++;
+}
+
+static bool store_insert(Store* store, cJSON* item, uint64_t hash, uint64_t value)
+{
+	// Full, give up the entry that would expire first
+	if (store->timed && store->count >= STORE_MAX_TIMED)
+		store_evict(store, store->heap[0]);
+
+	if ((store->count + store->removed + 1) * 4 > store->capacity * 3)
+		RAssert(store_resize(store, store->count * 2 + 1));
+
+	StoreEntry* slot;
+	store_find(store, item->string, hash, &slot);
+	if (slot->hash)
+		store->removed--;
+
+	slot->hash = hash;
+	slot->value = value;
+	slot->item = item;
+	store->count++;
+
+	if (store->timed)
+		RAssert(store_heap_push(store, slot));
+
+	return true;
+}
+
+/* Applies a change in memory only, false if it changed nothing */
+static bool store_apply_put(Store* store, const char* key, const char* name, uint64_t value)
+{
+	uint64_t hash = store_hash(key);
+	StoreEntry* entry = store_find(store, key, hash, NULL);
+	if (entry)
+	{
+		// Only timed entries change, nicknames stay from the first insert
+		if (!store->timed || entry->value == value)
+			return false;
+
+		entry->value = value;
+		cJSON_SetNumberValue(cJSON_GetArrayItem(entry->item, 1), (double)value);
+
+		store_heap_up(store, entry->heap);
+		store_heap_down(store, entry->heap);
+		return true;
+	}
+
+	cJSON* item;
+	if (store->timed)
+	{
+		item = cJSON_CreateArray();
+		if (item)
+		{
+			cJSON_AddItemToArray(item, cJSON_CreateString(name));
+			cJSON_AddItemToArray(item, cJSON_CreateNumber((double)value));
+		}
+	}
+	else
+		item = cJSON_CreateString(name);
+
+	RAssert(item);
+	cJSON_AddItemToObject(store->root, key, item);
+	RAssert(store_insert(store, item, hash, value));
+	return true;
+}
+
+static bool store_apply_remove(Store* store, const char* key)
+{
+	StoreEntry* entry = store_find(store, key, store_hash(key), NULL);
+	if (!entry)
+		return false;
+
+	store_evict(store, entry);
+	return true;
+}
+
+static void store_write16(uint8_t* out, size_t len)
+{
+	out[0] = (uint8_t)len;
+	out[1] = (uint8_t)(len >> 8);
+}
+
+/*
+	Journal record: op ('+' or '-'), key length (16-bit LE), key,
+	then for '+' name length, name and a 64-bit LE value.
+*/
+bool store_log(Store* store, char op, const char* key, const char* name, uint64_t value)
+{
+	if (!store->log)
+		return false;
+
+	size_t key_len = strlen(key);
+	size_t name_len = name ? strlen(name) : 0;
+	if (key_len > STORE_MAX_STRING || name_len > STORE_MAX_STRING)
+	{
+		Warn("%s: entry too long for the journal", store->journal);
+		return false;
+	}
+
+	uint8_t head[3] = { (uint8_t)op };
+	store_write16(head + 1, key_len);
+
+	bool res = fwrite(head, 1, 3, store->log) == 3 && fwrite(key, 1, key_len, store->log) == key_len;
+	if (op == '+')
+	{
+		uint8_t len[2], val[8];
+		store_write16(len, name_len);
+		for (int i = 0; i < 8; i++)
+			val[i] = (uint8_t)(value >> (i * 8));
+
+		res = res && fwrite(len, 1, 2, store->log) == 2 && fwrite(name, 1, name_len, store->log) == name_len && fwrite(val, 1, 8, store->log) == 8;
+	}
+
+	if (!res)
+	{
+		Warn("Failed to append to %s", store->journal);
+		return false;
+	}
+
+	if (store->log_ops++ == 0)
+		store->log_since = time(NULL);
+
+	return true;
+}
+
+bool store_flush(Store* store)
+{
+	if (!store->log || fflush(store->log) != 0)
+	{
+		Warn("Failed to flush %s", store->journal);
+		return false;
+	}
+
+	return true;
+}
+
+static bool store_read_string(FILE* file, char* out)
+{
+	uint8_t len[2];
+	if (fread(len, 1, 2, file) != 2)
+		return false;
+
+	size_t size = len[0] | (len[1] << 8);
+	if (size > STORE_MAX_STRING || fread(out, 1, size, file) != size)
+		return false;
+
+	out[size] = '\0';
+	return true;
+}
+
+static size_t store_replay(Store* store)
+{
+	FILE* file = fopen(store->journal, "rb");
+	if (!file)
+		return 0;
+
+	char key[STORE_MAX_STRING + 1], name[STORE_MAX_STRING + 1];
+	size_t records = 0;
+	int op;
+
+	while ((op = fgetc(file)) != EOF)
+	{
+		bool ok = (op == '+' || op == '-') && store_read_string(file, key);
+		if (ok && op == '+')
+		{
+			uint8_t val[8];
+			ok = store_read_string(file, name) && fread(val, 1, 8, file) == 8;
+
+			uint64_t value = 0;
+			for (int i = 0; ok && i < 8; i++)
+				value |= (uint64_t)val[i] << (i * 8);
+
+			if (ok)
+				store_apply_put(store, key, name, value);
+		}
+		else if (ok)
+			store_apply_remove(store, key);
+
+		// A crash can leave the last record half written
+		if (!ok)
+		{
+			Warn("%s: dropped a damaged record after %d good ones", store->journal, (int)records);
+			break;
+		}
+
+		records++;
+	}
+
+	fclose(file);
+	return records;
+}
+
+bool store_init(Store* store, const char* file, const char* journal, const char* default_value, bool timed, Mutex* lock)
+{
+	memset(store, 0, sizeof(Store));
+	store->file = file;
+	store->journal = journal;
+	store->timed = timed;
+	store->lock = lock;
+
+	// Import the JSON file, it stays the export format too
+	bool imported = collection_init(&store->root, file, default_value);
+	RAssert(store->root);
+	RAssert(store_resize(store, (size_t)cJSON_GetArraySize(store->root)));
+
+	cJSON* item = store->root->child;
+	while (item)
+	{
+		cJSON* next = item->next;
+		uint64_t value = 0;
+		bool valid = item->string != NULL;
+
+		if (valid && timed)
+		{
+			cJSON* stamp = cJSON_GetArrayItem(item, 1);
+			valid = cJSON_IsArray(item) && cJSON_IsNumber(stamp);
+			value = valid ? (uint64_t)cJSON_GetNumberValue(stamp) : 0;
+		}
+
+		if (valid && store_find(store, item->string, store_hash(item->string), NULL))
+			valid = false;
+
+		if (valid)
+		{
+			RAssert(store_insert(store, item, store_hash(item->string), value));
+		}
+		else
+		{
+			Warn("%s: dropped invalid or duplicate entry \"%s\"", file, item->string ? item->string : "");
+			cJSON_Delete(cJSON_DetachItemViaPointer(store->root, item));
+		}
+
+		item = next;
+	}
+
+	// Fold what the last run journaled into the JSON file, saving it also opens a new journal
+	size_t records = store_replay(store);
+	if (records > 0)
+		Debug("%s: replayed %d journal records", journal, (int)records);
+
+	size_t expired = store_expire(store, (uint64_t)time(NULL), SIZE_MAX);
+	if (expired > 0)
+		Debug("%s: dropped %d expired entries", file, (int)expired);
+
+	// A file that failed to parse is left for the user to fix, keep journaling after what is there
+	if (!imported)
+	{
+		Warn("%s is left untouched until the next change, its entries are not loaded", file);
+		store->log = fopen(journal, "ab");
+		store->log_ops = 0;
+		if (!store->log)
+			Warn("Failed to open %s for writing.", journal);
+	}
+	else
+	{
+		uint64_t seq;
+		char* json = store_snapshot(store, &seq);
+		RAssert(json);
+
+		bool res = store_save(store, json, seq);
+		free(json);
+
+		RAssert(res);
+	}
+
+	Debug("%s indexed (%d entries)", file, (int)store->count);
+	return true;
+}
+
+StoreEntry* store_get(Store* store, const char* key)
+{
+	if (!store->slots)
+		return NULL;
+
+	return store_find(store, key, store_hash(key), NULL);
+}
+
+bool store_put(Store* store, const char* key, const char* name, uint64_t value)
+{
+	if (!store_apply_put(store, key, name, value))
+		return true;
+
+	if (store->hook)
+		store->hook(store, key, true);
+
+	return persist_push(store, ++store->seq, '+', key, name, value);
+}
+
+bool store_remove(Store* store, const char* key)
+{
+	// Key may belong to the entry being removed, queue before it is freed
+	StoreEntry* entry = store_get(store, key);
+	if (!entry)
+		return false;
+
+	if (store->hook)
+		store->hook(store, key, false);
+
+	bool res = persist_push(store, ++store->seq, '-', key, NULL, 0);
+	store_apply_remove(store, key);
+	return res;
+}
+
+size_t store_expire(Store* store, uint64_t now, size_t max)
+{
+	size_t count = 0;
+	while (count < max && store->heap_count > 0 && store->heap[0]->value <= now)
+	{
+		store_evict(store, store->heap[0]);
+		count++;
+	}
+
+	// Not journaled, counts toward compaction so the JSON file sheds them too
+	if (count > 0 && store->log_ops == 0)
+		store->log_since = time(NULL);
+
+	store->log_ops += count;
+	return count;
+}
+
+bool store_due(Store* store)
+{
+	// A full disk or a read-only directory won't fix itself within one drain
+	if (store->save_retry && time(NULL) < store->save_retry)
+		return false;
+
+	if (store->log_ops >= STORE_COMPACT_OPS)
+		return true;
+
+	return store->log_ops > 0 && time(NULL) - store->log_since >= STORE_COMPACT_SECS;
+}
+
+char* store_snapshot(Store* store, uint64_t* seq)
+{
+	if (store->removed > store->count)
+		store_resize(store, store->count);
+
+	*seq = store->seq;
+	return cJSON_Print(store->root);
+}
+
+static bool store_save_failed(Store* store)
+{
+	store->save_wait = store->save_wait ? store->save_wait * 2 : STORE_RETRY_SECS;
+	if (store->save_wait > STORE_COMPACT_SECS)
+		store->save_wait = STORE_COMPACT_SECS;
+
+	store->save_retry = time(NULL) + store->save_wait;
+	Warn("Saving %s failed, next try in %ds", store->file, (int)store->save_wait);
+	return false;
+}
+
+bool store_save(Store* store, const char* json, uint64_t seq)
+{
+	char tmp[256];
+	snprintf(tmp, sizeof(tmp), "%s.tmp", store->file);
+
+	// Write the snapshot aside and swap it in, a crash leaves either file whole
+	FILE* file = fopen(tmp, "w");
+	if (!file)
+	{
+		Warn("Failed to open %s for writing.", tmp);
+		return store_save_failed(store);
+	}
+
+	// On disk before the rename, or a crash could swap in a file that was never written
+	size_t len = strlen(json);
+	bool res = fwrite(json, 1, len, file) == len && fflush(file) == 0 && store_sync(file) == 0;
+	res = fclose(file) == 0 && res;
+	if (!res)
+	{
+		Warn("Failed to write %s", tmp);
+		remove(tmp);
+		return store_save_failed(store);
+	}
+
+#ifdef _WIN32
+	if (!MoveFileExA(tmp, store->file, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+#else
+	if (rename(tmp, store->file) != 0)
+#endif
+	{
+		Warn("Failed to replace %s", store->file);
+		return store_save_failed(store);
+	}
+
+	store->save_retry = 0;
+	store->save_wait = 0;
+
+	// Records up to seq are in the file now, queued ones past it go to the new journal
+	store->saved_seq = seq;
+	if (store->log)
+		fclose(store->log);
+
+	store->log = fopen(store->journal, "wb");
+	store->log_ops = 0;
+	if (!store->log)
+	{
+		Warn("Failed to open %s for writing.", store->journal);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,113 @@
+#include <Zone.h>
+#include <MapData.h>
+#include <Log.h>
+#include <math.h>
+#include <stdlib.h>
+
+ZoneGrid g_zoneGrid[21];
+
+static void zone_grid_cells(const ZoneGrid* grid, const ZoneRect* zone, int32_t* x0, int32_t* y0, int32_t* x1, int32_t* y1)
+{
+	// Zone edges are inclusive, so is the last cell they touch
+	*x0 = (int32_t)floor((zone->x - grid->x) / ZONEGRID_CELL);
+	*y0 = (int32_t)floor((zone->y - grid->y) / ZONEGRID_CELL);
+	*x1 = (int32_t)floor((zone->x + zone->w - grid->x) / ZONEGRID_CELL);
+	*y1 = (int32_t)floor((zone->y + zone->h - grid->y) / ZONEGRID_CELL);
+}
+
+static bool zone_grid_build(ZoneGrid* grid, const ZoneRect* zones, size_t count)
+{
+	memset(grid, 0, sizeof(ZoneGrid));
+	if (count == 0)
+		return true;
+
+	double max_x = zones[0].x + zones[0].w, max_y = zones[0].y + zones[0].h;
+	grid->x = zones[0].x;
+	grid->y = zones[0].y;
+
+	for (size_t i = 1; i < count; i++)
+	{
+		grid->x = fmin(grid->x, zones[i].x);
+		grid->y = fmin(grid->y, zones[i].y);
+		max_x = fmax(max_x, zones[i].x + zones[i].w);
+		max_y = fmax(max_y, zones[i].y + zones[i].h);
+	}
+
+	grid->cols = (int32_t)floor((max_x - grid->x) / ZONEGRID_CELL) + 1;
+	grid->rows = (int32_t)floor((max_y - grid->y) / ZONEGRID_CELL) + 1;
+
+	size_t cells = (size_t)grid->cols * grid->rows;
+	grid->start = (uint32_t*)calloc(cells + 1, sizeof(uint32_t));
+	RAssert(grid->start);
+
+	// Count per cell, then turn the counts into offsets
+	int32_t x0, y0, x1, y1;
+	for (size_t i = 0; i < count; i++)
+	{
+		zone_grid_cells(grid, &zones[i], &x0, &y0, &x1, &y1);
+		for (int32_t y = y0; y <= y1; y++)
+			for (int32_t x = x0; x <= x1; x++)
+				grid->start[y * grid->cols + x + 1]++;
+	}
+
+	for (size_t i = 0; i < cells; i++)
+		grid->start[i + 1] += grid->start[i];
+
+	grid->zones = (uint16_t*)malloc(grid->start[cells] * sizeof(uint16_t));
+	RAssert(grid->zones);
+
+	uint32_t* fill = (uint32_t*)malloc(cells * sizeof(uint32_t));
+	RAssert(fill);
+	memcpy(fill, grid->start, cells * sizeof(uint32_t));
+
+	for (size_t i = 0; i < count; i++)
+	{
+		zone_grid_cells(grid, &zones[i], &x0, &y0, &x1, &y1);
+		for (int32_t y = y0; y <= y1; y++)
+			for (int32_t x = x0; x <= x1; x++)
+				grid->zones[fill[y * grid->cols + x]++] = (uint16_t)i;
+	}
+
+	free(fill);
+	return true;
+}
+
+bool zone_grid_init(void)
+{
+	size_t entries = 0;
+	for (int i = 0; i < 21; i++)
+	{
+		RAssert(zone_grid_build(&g_zoneGrid[i], g_mapData.zones[i], g_mapData.zone_count[i]));
+
+		if (g_zoneGrid[i].start)
+			entries += g_zoneGrid[i].start[g_zoneGrid[i].cols * g_zoneGrid[i].rows];
+	}
+
+	Debug("Zone grids built (%d cell entries)", (int)entries);
+	return true;
+}
+
+int32_t zone_grid_cell(int map, double x, double y)
+{
+	const ZoneGrid* grid = &g_zoneGrid[map];
+	if (!grid->start)
+		return -1;
+
+	// Also rejects NaN
+	double cx = (x - grid->x) / ZONEGRID_CELL;
+	double cy = (y - grid->y) / ZONEGRID_CELL;
+	if (!(cx >= 0 && cy >= 0 && cx < grid->cols && cy < grid->rows))
+		return -1;
+
+	return (int32_t)cy * grid->cols + (int32_t)cx;
+}
+
+size_t zone_grid_list(int map, int32_t cell, const uint16_t** out)
+{
+	const ZoneGrid* grid = &g_zoneGrid[map];
+	if (cell < 0)
+		return 0;
+
+	*out = &grid->zones[grid->start[cell]];
+	return grid->start[cell + 1] - grid->start[cell];
+}
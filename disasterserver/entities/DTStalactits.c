@@ -59,20 +59,16 @@ bool dtst_tick(Server* server, Entity* entity)
 
 		if (titi->timer <= 0)
 		{
-			for (size_t i = 0; i < server->peers.capacity; i++)
+			// Trigger area below the stalactite
+			PeerData* below[PLAYERGRID_MAXQUERY];
+			size_t count = player_grid_rect(&server->game.players, titi->pos.x, titi->pos.y, 80, 336, below, PLAYERGRID_MAXQUERY);
+			for (size_t i = 0; i < count; i++)
 			{
-				PeerData* data = (PeerData*)server->peers.ptr[i];
-				if (!data)
-					continue;
-
-				if(!data->in_game)
-					continue;
-
+				PeerData* data = below[i];
 				if (data->plr.flags & PLAYER_DEAD)
 					continue;
 
-				float dist = data->plr.pos.y - titi->pos.y;
-				if (dist > 0 && dist <= 336 && data->plr.pos.x >= titi->pos.x && data->plr.pos.x <= titi->pos.x + 80)
+				if (data->plr.pos.y > titi->pos.y)
 				{
 					titi->vel = 0;
 
@@ -99,7 +95,7 @@ bool dtst_activate(Server* server, DTStalactits* tits)
 		
 	tits->show = false;
 	tits->state = false;
-	tits->timer = (25.0 + rand() % 5 ) * TICKSPERSEC;
+	tits->timer = (25.0 + rng_range(&server->rng, 5)) * TICKSPERSEC;
 	tits->pos.y = tits->sy;
 	tits->vel = 0;
 
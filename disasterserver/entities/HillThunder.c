@@ -20,7 +20,7 @@ bool thunder_tick(Server* server, Entity* entity)
 		PacketWrite(&pack, packet_write8, 1);
 		server_broadcast(server, &pack, true);
 
-		th->timer = (15 + (rand() % 5)) * TICKSPERSEC;
+		th->timer = (15 + rng_range(&server->rng, 5)) * TICKSPERSEC;
 		th->flag = false;
 		return true;
 	}
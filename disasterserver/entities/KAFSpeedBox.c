@@ -49,7 +49,7 @@ bool kafbox_activate(Server* server, KafBox* box, uint16_t pid, uint8_t is_proj)
 	server_broadcast(server, &pack, true);
 
 	box->activated = true;
-	box->timer = (25.0 + rand() % 5) * TICKSPERSEC;
+	box->timer = (25.0 + rng_range(&server->rng, 5)) * TICKSPERSEC;
 
 	return true;
 }
@@ -14,7 +14,7 @@ bool mass_tick(Server* server, Entity* entity)
 		PacketWrite(&pack, packet_write8, ass->state);
 		server_broadcast(server, &pack, true);
 
-		ass->next_time = (10 + rand() % 5) * TICKSPERSEC;
+		ass->next_time = (10 + rng_range(&server->rng, 5)) * TICKSPERSEC;
 	}
 
 	ass->timer += server->delta;
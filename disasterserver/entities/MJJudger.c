@@ -17,14 +17,14 @@ bool mjew_tick(Server* server, Entity* entity)
 			case MJJ_PREPARE:
 			{
 				ass->state = MJJ_FIRE;
-				ass->next_time = (7 + rand() % 2) * TICKSPERSEC;
+				ass->next_time = (7 + rng_range(&server->rng, 2)) * TICKSPERSEC;
 				break;
 			}
 
 			case MJJ_FIRE:
 			{
 				ass->state = MJJ_WAIT;
-				ass->next_time = (10 + rand() % 5) * TICKSPERSEC;
+				ass->next_time = (10 + rng_range(&server->rng, 5)) * TICKSPERSEC;
 				break;
 			}
 		}
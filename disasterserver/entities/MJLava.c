@@ -43,7 +43,7 @@ bool mlava_tick(Server* server, Entity* entity)
 		else
 		{
 			lv->state = MLV_MOVE;
-			lv->timer = (4.0 + rand() % 3) * TICKSPERSEC;
+			lv->timer = (4.0 + rng_range(&server->rng, 3)) * TICKSPERSEC;
 			lv->vel = 0;
 		}
 
@@ -74,7 +74,7 @@ bool mlava_tick(Server* server, Entity* entity)
 		else
 		{
 			lv->state = MLV_IDLE;
-			lv->timer = (5.0 + rand() % 4) * TICKSPERSEC;
+			lv->timer = (5.0 + rng_range(&server->rng, 4)) * TICKSPERSEC;
 			lv->vel = 0;
 		}
 
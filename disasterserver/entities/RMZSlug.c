@@ -43,7 +43,7 @@ bool slug_init(Server* server, Entity* entity)
 {
 	Slug* slug = (Slug*)entity;
 
-	int num = rand() % 100;
+	int num = rng_range(&server->rng, 100);
 	if (num < 50)
 		slug->ring = SLUG_NORING;
 	else if (num >= 40 && num < 90)
@@ -55,7 +55,7 @@ bool slug_init(Server* server, Entity* entity)
 	slug->sY = slug->pos.y;
 
 	// make it face random dir
-	slug_face(slug, rand() % 2);
+	slug_face(slug, rng_range(&server->rng, 2));
 
 	Packet pack;
 	PacketCreate(&pack, SERVER_RMZSLIME_STATE);
@@ -115,7 +115,7 @@ bool slug_uninit(Server* server, Entity* entity)
 	// find slug spawner and free it
 	SlugSpawner* spawners[11];
 
-	int found = game_find(server, (Entity**)spawners, "slugspawn", 11);
+	int found = game_find_type(server, (Entity**)spawners, ET_SLUGSPAWNER, 11);
 	for (int i = 0; i < found; i++)
 	{
 		if (spawners[i]->slug == entity->id)
@@ -149,7 +149,7 @@ bool slugspawn_tick(Server* server, Entity* entity)
 		
 		spawn->timer = 0;
 		spawn->slug = slug->id;
-		spawn->offset = (double)((rand() % 2) * TICKSPERSEC);
+		spawn->offset = (double)(rng_range(&server->rng, 2) * TICKSPERSEC);
 	}
 
 	return true;
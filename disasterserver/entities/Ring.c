@@ -18,14 +18,14 @@ bool ring_init(Server* server, Entity* entity)
 
 	int rnd;
 gen:
-	rnd = rand() % g_mapList[server->game.map].ring_count;
+	rnd = rng_range(&server->rng, g_mapList[server->game.map].ring_count);
 
 	if (server->game.rings[rnd])
 		goto gen;
 
 	server->game.rings[rnd] = true;
 	ring->rid = (uint8_t)rnd;
-	ring->red = g_mapList[server->game.map].spawn_red_rings && (rand() % 100 <= 10);
+	ring->red = g_mapList[server->game.map].spawn_red_rings && rng_range(&server->rng, 100) <= 10;
 
 	Packet pack;
 	PacketCreate(&pack, SERVER_RING_STATE);
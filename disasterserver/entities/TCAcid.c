@@ -11,7 +11,7 @@ bool acid_tick(Server* server, Entity* entity)
 		ac->activated = !ac->activated;
 
 		if (ac->activated)
-			ac->acid_id = rand() % 7;
+			ac->acid_id = rng_range(&server->rng, 7);
 
 		Packet pack;
 		PacketCreate(&pack, SERVER_TCGOM_STATE);
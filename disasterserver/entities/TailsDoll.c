@@ -1,53 +1,29 @@
 #include "Server.h"
 #include <entities/TailsDoll.h>
 #include <CMath.h>
+#include <MapData.h>
 
-Vector2 spots[11] =
-{
-	{ 177, 944 },
-	{ 1953, 544 },
-	{ 3279, 224 },
-	{ 4101, 544 },
-	{ 4060, 1264 },
-	{ 3805, 1824 },
-	{ 2562, 1584 },
-	{ 515,  1824 },
-	{ 2115, 1056 },
-	{ 984,  1184 },
-	{ 1498, 1504 }
-};
-	
 void tdoll_find_spot(Server* server, TailsDoll* doll)
 {
-	Vector2 new_spots[11];
+	const SpawnPoint* spots = g_mapData.spawns[SPAWN_TDOLL];
+	uint16_t spot_count = g_mapData.spawn_count[SPAWN_TDOLL];
+
+	Vector2 new_spots[MAPDATA_MAXSPAWNS];
 	int     new_count = 0;
 
-	for (int i = 0; i < 11; i++)
+	for (uint16_t i = 0; i < spot_count; i++)
 	{
-		bool can_use = true; 
-		for (size_t j = 0; j < server->peers.capacity; j++)
-		{
-			PeerData* data = (PeerData*)server->peers.ptr[j];
-			if (!data)
-				continue;
-
-			if(!data->in_game)
-				continue;
-
-			if (vector2_dist(&spots[i], &data->plr.pos) < 480.f)
-			{
-				can_use = false;
-				break;
-			}
-		}
+		Vector2 spot = { spots[i].x, spots[i].y };
 
-		if(can_use)
-			new_spots[new_count++] = spots[i];
+		// Any player in range (alive or not) rules the spot out
+		PeerData* near;
+		if (player_grid_radius(&server->game.players, spot, 480.f, &near, 1) == 0)
+			new_spots[new_count++] = spot;
 	}
 
 	if (new_count > 0)
 	{
-		int ball = rand() % new_count;
+		int ball = rng_range(&server->rng, new_count);
 		Vector2 spot = new_spots[ball];
 		doll->pos.x = spot.x;
 		doll->pos.y = spot.y;
@@ -56,7 +32,7 @@ void tdoll_find_spot(Server* server, TailsDoll* doll)
 	}
 	else
 	{
-		Vector2 spot = spots[rand() % 11];
+		SpawnPoint spot = spots[rng_range(&server->rng, spot_count)];
 		doll->pos.x = spot.x;
 		doll->pos.y = spot.y;
 
@@ -102,13 +78,15 @@ bool tdoll_find_target(Server* server, TailsDoll* doll)
 	Vector2 pos = { doll->pos.x, doll->pos.y };
 
 	// scan for people
-	for (size_t i = 0; i < server->peers.capacity; i++)
-	{
-		PeerData* data = (PeerData*)server->peers.ptr[i];
-		if (!data)
-			continue;
+	const PlayerGridItem* near[PLAYERGRID_MAXQUERY];
+	size_t count = player_grid_radius_ex(&server->game.players, pos, 130, near, PLAYERGRID_MAXQUERY);
 
-		if(!data->in_game)
+	// The grid answers in cell order, take the eligible hit first in peer order like the full scan did
+	const PlayerGridItem* best = NULL;
+	for (size_t i = 0; i < count; i++)
+	{
+		PeerData* data = near[i]->peer;
+		if (best && near[i]->index > best->index)
 			continue;
 
 		if (data->id == server->game.exe)
@@ -123,14 +101,14 @@ bool tdoll_find_target(Server* server, TailsDoll* doll)
 		if (data->plr.flags & PLAYER_ESCAPED)
 			continue;
 
-		if (vector2_dist(&data->plr.pos, &pos) < 130)
-		{
-			doll->target = data->id;
-			return true;
-		}
+		best = near[i];
 	}
 
-	return false;
+	if (!best)
+		return false;
+
+	doll->target = best->peer->id;
+	return true;
 }
 
 bool tdoll_init(Server* server, Entity* entity)
@@ -158,7 +136,7 @@ bool tdoll_tick(Server* server, Entity* entity)
 		{
 			if (tdoll_find_target(server, doll))
 			{
-				doll->timer = (1 + (rand() % 2) * 0.5) * TICKSPERSEC;
+				doll->timer = (1 + rng_range(&server->rng, 2) * 0.5) * TICKSPERSEC;
 				doll->state = TDST_READY;
 
 				Packet pack;
@@ -43,7 +43,7 @@ bool lava_tick(Server* server, Entity* entity)
 			else
 			{
 				lv->state = LV_MOVE;
-				lv->timer = (4.0 + rand() % 3) * TICKSPERSEC;
+				lv->timer = (4.0 + rng_range(&server->rng, 3)) * TICKSPERSEC;
 				lv->vel = 0;
 			}
 
@@ -74,7 +74,7 @@ bool lava_tick(Server* server, Entity* entity)
 			else
 			{
 				lv->state = LV_IDLE;
-				lv->timer = (20.0 + rand() % 5) * TICKSPERSEC;
+				lv->timer = (20.0 + rng_range(&server->rng, 5)) * TICKSPERSEC;
 				lv->vel = 0;
 			}
 
@@ -9,7 +9,7 @@ bool latern_tick(Server* server, Entity* entity)
 	{
 		if (lat->timer >= lat->time * TICKSPERSEC)
 		{
-			lat->lid = rand() % 7;
+			lat->lid = rng_range(&server->rng, 7);
 
 			Packet pack;
 			PacketCreate(&pack, SERVER_WDLATERN_ACTIVATE);
@@ -19,7 +19,7 @@ bool latern_tick(Server* server, Entity* entity)
 
 			lat->side = true;
 			lat->timer = 0;
-			lat->time = (20 + rand() % 2);
+			lat->time = (20 + rng_range(&server->rng, 2));
 		}
 	}
 	else
@@ -34,7 +34,7 @@ bool latern_tick(Server* server, Entity* entity)
 
 			lat->side = false;
 			lat->timer = 0;
-			lat->time = (7 + rand() % 2);
+			lat->time = (7 + rng_range(&server->rng, 2));
 		}
 	}
 
@@ -30,7 +30,7 @@ bool ycrctrl_tick(Server* server, Entity* entity)
 				ctrl->activated = !ctrl->activated;
 
 				if (ctrl->activated)
-					ctrl->smoke_id = rand() % 7;
+					ctrl->smoke_id = rng_range(&server->rng, 7);
 				else
 					ctrl->smoke_id = 0;
 
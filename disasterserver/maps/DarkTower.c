@@ -32,7 +32,7 @@ bool dt_init(Server* server)
 	return true;
 }
 
-bool dt_tcpmsg(PeerData* v, Packet* packet)
+bool dt_tcpmsg(PeerData* v, PacketView* packet)
 {
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -46,7 +46,7 @@ bool dt_tcpmsg(PeerData* v, Packet* packet)
 			AssertOrDisconnect(v->server, sid < 14);
 
 			DTStalactits* ents[14];
-			if (!game_find(v->server, (Entity**)ents, "dttits", 14))
+			if (!game_find_type(v->server, (Entity**)ents, ET_DTSTALACTITS, 14))
 				break;
 
 			RAssert(dtst_activate(v->server, ents[sid]));
@@ -20,7 +20,7 @@ bool ft_init(Server* server)
 	return true;
 }
 
-bool ft_tcpmsg(PeerData* v, Packet* packet)
+bool ft_tcpmsg(PeerData* v, PacketView* packet)
 {
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -33,7 +33,7 @@ bool ft_tcpmsg(PeerData* v, Packet* packet)
 			PacketRead(spd, packet, packet_read8, int8_t);
 
 			Dummy* dum;
-			if (!game_find(v->server, (Entity**)&dum, "dummy", 1))
+			if (!game_find_type(v->server, (Entity**)&dum, ET_DUMMY, 1))
 				break;
 
 			dummy_activate(dum, spd);
@@ -11,7 +11,7 @@ bool hd_init(Server* server)
 	return true;
 }
 
-bool hd_tcpmsg(PeerData* v, Packet* packet)
+bool hd_tcpmsg(PeerData* v, PacketView* packet)
 {
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -22,7 +22,7 @@ bool hd_tcpmsg(PeerData* v, Packet* packet)
 		{
 			AssertOrDisconnect(v->server, v->in_game);
 			HDDoor* door;
-			if (!game_find(v->server, (Entity**)&door, "hddoor", 1))
+			if (!game_find_type(v->server, (Entity**)&door, ET_HDDOOR, 1))
 				break;
 			
 			hddoor_toggle(v->server, door);
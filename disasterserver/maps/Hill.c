@@ -8,7 +8,7 @@ bool hill_init(Server* server)
 	RAssert(map_time(server, 3 * TICKSPERSEC, 20));
 	RAssert(map_ring(server, 5));
 
-	RAssert(game_spawn(server, (Entity*)&(MakeThunder()), sizeof(Thunder), NULL));
+	RAssert(game_spawn(server, (Entity*)&(MakeThunder(server)), sizeof(Thunder), NULL));
 
 	return true;
 }
\ No newline at end of file
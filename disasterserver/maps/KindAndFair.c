@@ -13,7 +13,7 @@ bool kaf_init(Server* server)
 	return true;
 }
 
-bool kaf_tcpmsg(PeerData* v, Packet* packet)
+bool kaf_tcpmsg(PeerData* v, PacketView* packet)
 {
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -27,7 +27,7 @@ bool kaf_tcpmsg(PeerData* v, Packet* packet)
 			PacketRead(proj, packet, packet_read8, uint8_t);
 
 			KafBox* box[11];
-			if (!game_find(v->server, (Entity**)box, "kafbox", 11))
+			if (!game_find_type(v->server, (Entity**)box, ET_KAFBOX, 11))
 				break;
 
 			RAssert(kafbox_activate(v->server, box[nid], v->id, proj));
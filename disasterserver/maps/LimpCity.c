@@ -14,7 +14,7 @@ bool lc_init(Server* server)
 	return true;
 }
 
-bool lc_tcpmsg(PeerData* v, Packet* packet)
+bool lc_tcpmsg(PeerData* v, PacketView* packet)
 {
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -30,7 +30,7 @@ bool lc_tcpmsg(PeerData* v, Packet* packet)
 			AssertOrDisconnect(v->server, v->in_game);
 
 			LCEye* eyes[2];
-			if (!game_find(v->server, (Entity**)eyes, "lceye", 2))
+			if (!game_find_type(v->server, (Entity**)eyes, ET_LCEYE, 2))
 				break;
 
 			LCEye* eye = eyes[nid];
@@ -10,7 +10,7 @@ bool mj_init(Server* server)
 
 	RAssert(game_spawn(server, (Entity*)&MakeMLava(1624, 512), sizeof(MLava), NULL));
 	RAssert(game_spawn(server, (Entity*)&MakeMAss(), sizeof(MAss), NULL));
-	RAssert(game_spawn(server, (Entity*)&MakeMJew(), sizeof(MJew), NULL));
+	RAssert(game_spawn(server, (Entity*)&MakeMJew(server), sizeof(MJew), NULL));
 
 	return true;
 }
\ No newline at end of file
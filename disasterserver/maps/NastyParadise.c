@@ -46,7 +46,7 @@ bool nap_init(Server* server)
 	return true;
 }
 
-bool nap_tcpmsg(PeerData* v, Packet* packet)
+bool nap_tcpmsg(PeerData* v, PacketView* packet)
 {
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -60,7 +60,7 @@ bool nap_tcpmsg(PeerData* v, Packet* packet)
 			AssertOrDisconnect(v->server, iid < 10);
 
 			Ice* ices[10];
-			if (!game_find(v->server, (Entity**)ices, "ice", 10))
+			if (!game_find_type(v->server, (Entity**)ices, ET_ICE, 10))
 				break;
 			
 			RAssert(ice_activate(v->server, ices[iid]));
@@ -18,7 +18,7 @@ bool pf_init(Server* server)
 	return true;
 }
 
-bool pf_tcpmsg(PeerData* v, Packet* packet)
+bool pf_tcpmsg(PeerData* v, PacketView* packet)
 {
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -31,7 +31,7 @@ bool pf_tcpmsg(PeerData* v, Packet* packet)
 			PacketRead(lid, packet, packet_read8, uint8_t);
 
 			PFLift* ents[4];
-			int found = game_find(v->server, (Entity**)ents, "pflift", 4);
+			int found = game_find_type(v->server, (Entity**)ents, ET_PFLIFT, 4);
 			for (int i = 0; i < found; i++)
 			{
 				if (ents[i]->lid == lid)
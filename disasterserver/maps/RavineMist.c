@@ -3,14 +3,15 @@
 #include <entities/RMZShard.h>
 #include <States.h>
 #include <CMath.h>
+#include <MapData.h>
 
-void shuffle(Shard* array, size_t n)
+void shuffle(Server* server, Shard* array, size_t n)
 {
 	if (n > 1)
 	{
 		for (size_t i = 0; i < n - 1; i++)
 		{
-			size_t j = i + rand() / (RAND_MAX / (n - i) + 1);
+			size_t j = i + rng_range(&server->rng, (uint32_t)(n - i));
 			Shard t = array[j];
 			array[j] = array[i];
 			array[i] = t;
@@ -20,7 +21,7 @@ void shuffle(Shard* array, size_t n)
 
 bool rmz_checkstate(Server* server)
 {
-	uint8_t total = 7 - game_find(server, NULL, "shard", 7);
+	uint8_t total = 7 - game_find_type(server, NULL, ET_SHARD, 7);
 
 	Packet pack;
 	PacketCreate(&pack, SERVER_RMZSHARD_STATE);
@@ -30,7 +31,7 @@ bool rmz_checkstate(Server* server)
 
 	if (server->game.time_sec <= TICKSPERSEC - 10)
 	{
-		uint8_t total = 7 - game_find(server, NULL, "shard", 7);
+		uint8_t total = 7 - game_find_type(server, NULL, ET_SHARD, 7);
 		game_bigring(server, total >= 6 ? BS_ACTIVATED : BS_DEACTIVATED);
 	}
 
@@ -42,7 +43,7 @@ bool rmz_spawnshards(Server* server, Player* player)
 	for (uintptr_t i = 0; i < player->data[0]; i++)
 	{
 		Debug("shard spawned at %f %f", player->pos.x, player->pos.y);
-		RAssert(game_spawn(server, (Entity*)&(MakeShard((player->pos.x + (-8 + rand() % 17)), player->pos.y, 1)), sizeof(Shard), NULL));
+		RAssert(game_spawn(server, (Entity*)&(MakeShard((player->pos.x + (-8 + (int)rng_range(&server->rng, 17))), player->pos.y, 1)), sizeof(Shard), NULL));
 	}
 
 	player->data[0] = 0;
@@ -55,35 +56,19 @@ bool rmz_init(Server* server)
 	RAssert(map_ring(server, 5));
 
 	// slugs
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(1901, 392)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(2193, 392)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(2468, 392)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(1188, 860)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(2577, 1952)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(2564, 2264)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(2782, 2264)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(1441, 2264)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(884, 2264)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(988, 2004)), sizeof(SlugSpawner), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(915, 2004)), sizeof(SlugSpawner), NULL));
-
-	// shards
-	Shard shards[12] = 
-	{
-		MakeShard(862, 248, 0),
-		MakeShard(3078, 248, 0),
-		MakeShard(292, 558, 0),
-		MakeShard(2918, 558, 0),
-		MakeShard(1100, 820, 0),
-		MakeShard(980, 1188, 0),
-		MakeShard(1870, 1252, 0),
-		MakeShard(2180, 1508, 0),
-		MakeShard(2920, 2216, 0),
-		MakeShard(282, 2228, 0),
-		MakeShard(1318, 1916, 0),
-		MakeShard(3010, 1766, 0),
-	};
-	shuffle(shards, 12);
+	const SpawnPoint* spawns = g_mapData.spawns[SPAWN_RMZ_SLUG];
+	for (uint16_t i = 0; i < g_mapData.spawn_count[SPAWN_RMZ_SLUG]; i++)
+		RAssert(game_spawn(server, (Entity*)&(MakeSlugSpawn(server, spawns[i].x, spawns[i].y)), sizeof(SlugSpawner), NULL));
+
+	// shards, the table has at least 7 (checked on load)
+	Shard shards[MAPDATA_MAXSPAWNS];
+	uint16_t shard_count = g_mapData.spawn_count[SPAWN_RMZ_SHARD];
+
+	spawns = g_mapData.spawns[SPAWN_RMZ_SHARD];
+	for (uint16_t i = 0; i < shard_count; i++)
+		shards[i] = MakeShard(spawns[i].x, spawns[i].y, 0);
+
+	shuffle(server, shards, shard_count);
 
 	for (int i = 0; i < 7; i++)
 		RAssert(game_spawn(server, (Entity*)&shards[i], sizeof(Shard), NULL));
@@ -100,7 +85,7 @@ bool rmz_tick(Server* server)
 
 		if (server->game.time_sec <= TICKSPERSEC - 10 && server->game.bring_state < BS_ACTIVATED)
 		{
-			if((7 - game_find(server, NULL, "shard", 7) >= 6))
+			if((7 - game_find_type(server, NULL, ET_SHARD, 7) >= 6))
 				game_bigring(server, BS_ACTIVATED);
 		}
 	}
@@ -108,7 +93,7 @@ bool rmz_tick(Server* server)
 	return true;
 }
 
-bool rmz_tcpmsg(PeerData* v, Packet* packet)
+bool rmz_tcpmsg(PeerData* v, PacketView* packet)
 {
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -130,7 +115,7 @@ bool rmz_tcpmsg(PeerData* v, Packet* packet)
 			
 			if (proj)
 			{
-				free(ent);
+				game_free(v->server, (Entity*)ent);
 				break;
 			}
 
@@ -150,7 +135,7 @@ bool rmz_tcpmsg(PeerData* v, Packet* packet)
 				RAssert(packet_send(v->peer, &pack, true));
 			}
 
-			free(ent);
+			game_free(v->server, (Entity*)ent);
 			break;
 		}
 
@@ -175,7 +160,7 @@ bool rmz_tcpmsg(PeerData* v, Packet* packet)
 			PacketWrite(&pack, packet_write16, ent->id);
 			PacketWrite(&pack, packet_write16, v->id);
 			server_broadcast(v->server, &pack, true);
-			free(ent);
+			game_free(v->server, (Entity*)ent);
 
 			RAssert(rmz_checkstate(v->server));
 			break;
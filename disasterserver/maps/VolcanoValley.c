@@ -9,17 +9,17 @@ bool vv_init(Server* server)
 	RAssert(map_ring(server, 5));
 
 	for (uint8_t i = 0; i < 14; i++)
-		RAssert(game_spawn(server, (Entity*)&(MakeVase(i)), sizeof(Vase), NULL));
+		RAssert(game_spawn(server, (Entity*)&(MakeVase(server, i)), sizeof(Vase), NULL));
 
-	RAssert(game_spawn(server, (Entity*)&(MakeLava(0, 736, 130)), sizeof(Lava), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeLava(1, 1388, 130)), sizeof(Lava), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeLava(2, 1524, 130)), sizeof(Lava), NULL));
-	RAssert(game_spawn(server, (Entity*)&(MakeLava(3, 1084, 130)), sizeof(Lava), NULL));
+	RAssert(game_spawn(server, (Entity*)&(MakeLava(server, 0, 736, 130)), sizeof(Lava), NULL));
+	RAssert(game_spawn(server, (Entity*)&(MakeLava(server, 1, 1388, 130)), sizeof(Lava), NULL));
+	RAssert(game_spawn(server, (Entity*)&(MakeLava(server, 2, 1524, 130)), sizeof(Lava), NULL));
+	RAssert(game_spawn(server, (Entity*)&(MakeLava(server, 3, 1084, 130)), sizeof(Lava), NULL));
 
 	return true;
 }
 
-bool vv_tcpmsg(PeerData* v, Packet* packet)
+bool vv_tcpmsg(PeerData* v, PacketView* packet)
 {
 	PacketRead(passtrough, packet, packet_read8, uint8_t);
 	PacketRead(type, packet, packet_read8, uint8_t);
@@ -32,7 +32,7 @@ bool vv_tcpmsg(PeerData* v, Packet* packet)
 			PacketRead(vid, packet, packet_read8, uint8_t);
 
 			Vase* ents[14];
-			int found = game_find(v->server, (Entity**)ents, "vase", 14);
+			int found = game_find_type(v->server, (Entity**)ents, ET_VASE, 14);
 			for (int i = 0; i < found; i++)
 			{
 				if (ents[i]->vid == vid)
@@ -0,0 +1,182 @@
+#include <entities/RMZSlug.h>
+#include <entities/RMZShard.h>
+#include <entities/Ring.h>
+#include <entities/TailsDoll.h>
+#include <maps/RavineMist.h>
+#include <MapData.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+	Times the shipped game_entity_tick against the loop it replaced, which
+	walked every slot of a 3000 entry DyList and called each malloc'd
+	entity's tick through its own pointer. Entities come from the real
+	rmz_init and game_spawn: a Ravine Mist round with every spawner owning
+	its slug, then again with extra slugs and Tails Dolls so every added
+	entity ticks. Both loops run the real ticks on a server without peers,
+	packets are built and dropped.
+*/
+#define BENCH_CAPACITY	3000	/* Same as game.entities */
+#define BENCH_TICKS		20000
+
+static Server server;
+static Entity* old_ents[BENCH_CAPACITY];
+static Entity* new_ents[BENCH_CAPACITY];
+
+/* The loop before per-type lists */
+static bool bench_tick_old(DyList* list)
+{
+	int32_t entits[100];
+	int entit = 0;
+
+	for (int i = 0; i < 100; i++)
+		entits[i] = -1;
+
+	for (size_t i = 0; i < list->capacity; i++)
+	{
+		Entity* ent = (Entity*)list->ptr[i];
+		if (!ent)
+			continue;
+
+		if (ent->tick && !ent->tick(&server, ent))
+			entits[entit++] = ent->id;
+	}
+
+	return entits[0] == -1;
+}
+
+/* Entity setup of game_init, without the players */
+static bool bench_game_init(void)
+{
+	server.game = (Game) { .map = 1 };
+	RAssert(slotmap_create(&server.game.entities, BENCH_CAPACITY));
+
+	server.game.despawn = (uint16_t*)malloc(server.game.entities.capacity * sizeof(uint16_t));
+	RAssert(server.game.despawn);
+	return true;
+}
+
+static void bench_game_uninit(void)
+{
+	slotmap_free(&server.game.entities);
+	free(server.game.despawn);
+	player_grid_free(&server.game.players);
+	pool_reset(&server.game.pool);
+}
+
+static bool bench_make_round(size_t extra)
+{
+	RAssert(rmz_init(&server));
+
+	// A few seconds in every spawner owns a slug and the map is full of rings
+	for (Entity* ent = server.game.type_head[ET_SLUGSPAWNER]; ent; ent = ent->type_next)
+	{
+		Entity* slug;
+		RAssert(game_spawn(&server, (Entity*)&(MakeSlug(ent->pos.x, ent->pos.y)), sizeof(Slug), &slug));
+		((SlugSpawner*)ent)->slug = slug->id;
+	}
+
+	for (int i = 0; i < g_mapList[server.game.map].ring_count; i++)
+		RAssert(game_spawn(&server, (Entity*)&(MakeRing()), sizeof(Ring), NULL));
+
+	for (size_t i = 0; i < extra; i++)
+	{
+		if (i % 4 == 3)
+		{
+			RAssert(game_spawn(&server, (Entity*)&(MakeTailsDoll()), sizeof(TailsDoll), NULL));
+		}
+		else
+		{
+			RAssert(game_spawn(&server, (Entity*)&(MakeSlug((float)(900 + i * 8), 392)), sizeof(Slug), NULL));
+		}
+	}
+
+	return true;
+}
+
+static size_t bench_entity_size(EntityType type)
+{
+	switch (type)
+	{
+		case ET_SLUG:			return sizeof(Slug);
+		case ET_SLUGSPAWNER:	return sizeof(SlugSpawner);
+		case ET_SHARD:			return sizeof(Shard);
+		case ET_RING:			return sizeof(Ring);
+		case ET_TAILSDOLL:		return sizeof(TailsDoll);
+		default:				return sizeof(Entity);
+	}
+}
+
+static bool bench_run(size_t extra)
+{
+	RAssert(bench_game_init());
+	RAssert(bench_make_round(extra));
+
+	// Old side gets malloc'd copies in spawn order, as game_spawn used to make them
+	DyList list;
+	RAssert(dylist_create(&list, BENCH_CAPACITY));
+
+	size_t count = server.game.entities.noitems;
+	for (size_t i = 0; i < count; i++)
+	{
+		new_ents[i] = (Entity*)server.game.entities.items[i];
+
+		size_t size = bench_entity_size(new_ents[i]->etype);
+		old_ents[i] = (Entity*)malloc(size);
+		RAssert(old_ents[i]);
+
+		memcpy(old_ents[i], new_ents[i], size);
+		RAssert(dylist_push(&list, old_ents[i]));
+	}
+
+	clock_t start = clock();
+	for (int i = 0; i < BENCH_TICKS; i++)
+		RAssert(bench_tick_old(&list));
+	double old_ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / BENCH_TICKS;
+
+	start = clock();
+	for (int i = 0; i < BENCH_TICKS; i++)
+		RAssert(game_entity_tick(&server));
+	double new_ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / BENCH_TICKS;
+
+	// Same ticks on the same start, both sides have to end up in the same place
+	RAssert(server.game.entities.noitems == count);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (old_ents[i]->pos.x != new_ents[i]->pos.x || old_ents[i]->pos.y != new_ents[i]->pos.y)
+		{
+			fprintf(stderr, "%d entities: old and new ticks disagree on entity %d\n", (int)count, (int)new_ents[i]->id);
+			return false;
+		}
+
+		free(old_ents[i]);
+	}
+
+	printf("%3d entities (%3d ticking): old %8.1f ns, new %8.1f ns per tick (%.2fx)\n",
+		(int)count, (int)(count - server.game.type_count[ET_RING] - server.game.type_count[ET_SHARD]),
+		old_ns, new_ns, new_ns > 0 ? old_ns / new_ns : 0.0);
+
+	dylist_free(&list);
+	bench_game_uninit();
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (enet_initialize() != 0 || !map_data_init(argc > 1 ? argv[1] : MAPDATA_FILE))
+		return 1;
+
+	server.delta = 1;
+	rng_seed(&server.rng, 0x5EED);
+
+	static const size_t extra[] = { 0, 100, 400 };
+	for (size_t i = 0; i < sizeof(extra) / sizeof(*extra); i++)
+	{
+		if (!bench_run(extra[i]))
+			return 1;
+	}
+
+	enet_deinitialize();
+	return 0;
+}
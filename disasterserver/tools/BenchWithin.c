@@ -0,0 +1,110 @@
+#include <CMath.h>
+#include <Rng.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+	Compares vector2_within against the per-peer loops it replaced:
+	vector2_dist with a sqrtf per pair, and the same test on squared
+	distances without SIMD. Counts are the lobby size (7), a full grid
+	query (64) and something in between.
+*/
+#define BENCH_POINTS	64
+#define BENCH_CALLS		4000000
+
+static float xs[BENCH_POINTS], ys[BENCH_POINTS];
+static Vector2 centers[256];
+
+static uint64_t within_dist(const Vector2* center, size_t count, float radius)
+{
+	uint64_t mask = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector2 point = { xs[i], ys[i] };
+		if (vector2_dist(&point, (Vector2*)center) <= radius)
+			mask |= (uint64_t)1 << i;
+	}
+
+	return mask;
+}
+
+static uint64_t within_scalar(const Vector2* center, size_t count, float radius)
+{
+	uint64_t mask = 0;
+	float r2 = radius * radius;
+	for (size_t i = 0; i < count; i++)
+	{
+		float dx = xs[i] - center->x;
+		float dy = ys[i] - center->y;
+		if (dx * dx + dy * dy <= r2)
+			mask |= (uint64_t)1 << i;
+	}
+
+	return mask;
+}
+
+static double bench_seconds(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(void)
+{
+	Rng rng;
+	rng_seed(&rng, 0x5EED);
+
+	for (int i = 0; i < BENCH_POINTS; i++)
+	{
+		xs[i] = (float)rng_range(&rng, 4000);
+		ys[i] = (float)rng_range(&rng, 2000);
+	}
+
+	for (int i = 0; i < 256; i++)
+		centers[i] = (Vector2) { (float)rng_range(&rng, 4000), (float)rng_range(&rng, 2000) };
+
+#if defined(__AVX2__)
+	printf("vector2_within built with AVX2\n");
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	printf("vector2_within built with SSE2\n");
+#else
+	printf("vector2_within built without SIMD\n");
+#endif
+
+	static const size_t counts[] = { 7, 24, 64 };
+	for (size_t c = 0; c < sizeof(counts) / sizeof(*counts); c++)
+	{
+		size_t count = counts[c];
+		uint64_t sink = 0;
+
+		// Same answers first, the kernel promises bit-exact results
+		for (int i = 0; i < 256; i++)
+		{
+			if (vector2_within(&centers[i], xs, ys, count, 480) != within_scalar(&centers[i], count, 480))
+			{
+				fprintf(stderr, "mismatch at %d points\n", (int)count);
+				return 1;
+			}
+		}
+
+		clock_t start = clock();
+		for (int i = 0; i < BENCH_CALLS; i++)
+			sink += within_dist(&centers[i & 255], count, 480);
+		double dist = bench_seconds(start);
+
+		start = clock();
+		for (int i = 0; i < BENCH_CALLS; i++)
+			sink += within_scalar(&centers[i & 255], count, 480);
+		double scalar = bench_seconds(start);
+
+		start = clock();
+		for (int i = 0; i < BENCH_CALLS; i++)
+			sink += vector2_within(&centers[i & 255], xs, ys, count, 480);
+		double simd = bench_seconds(start);
+
+		printf("%2d points: vector2_dist %6.2f ns, scalar %6.2f ns, vector2_within %6.2f ns (%.1fx) [%llx]\n",
+			(int)count, dist * 1e9 / BENCH_CALLS, scalar * 1e9 / BENCH_CALLS, simd * 1e9 / BENCH_CALLS,
+			simd > 0 ? scalar / simd : 0.0, (unsigned long long)(sink & 0xF));
+	}
+
+	return 0;
+}
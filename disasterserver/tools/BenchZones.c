@@ -0,0 +1,140 @@
+#include <Zone.h>
+#include <MapData.h>
+#include <Config.h>
+#include <Rng.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+	Compares the per-map zone grid with the linear scan over every zone
+	rectangle that player_check_zone used to do each tick. Positions are
+	random points over each map's zone bounds; both sides must report
+	the same number of hits.
+*/
+#define BENCH_POINTS	4096
+#define BENCH_ROUNDS	256
+
+/* ZoneGrid and MapData log through these, the bench has no server around them */
+Config g_config;
+
+void log_fmt(const char* fmt, const char* type, const char* file, int line, ...)
+{
+	(void)type;
+	(void)file;
+	(void)line;
+
+	va_list args;
+	va_start(args, line);
+	vprintf(fmt, args);
+	va_end(args);
+	printf("\n");
+}
+
+static Vector2 points[BENCH_POINTS];
+
+static size_t zones_linear(int map, Vector2 pos)
+{
+	size_t hits = 0;
+	const Zone* zones = g_mapZone[map];
+	for (size_t i = 0; i < g_mapZoneSize[map]; i++)
+	{
+		const Zone zone = zones[i];
+		if (pos.x >= zone.x && pos.y >= zone.y && pos.x <= zone.x + zone.w && pos.y <= zone.y + zone.h)
+			hits++;
+	}
+
+	return hits;
+}
+
+static size_t zones_linear_packed(int map, Vector2 pos)
+{
+	size_t hits = 0;
+	const ZoneRect* zones = g_mapData.zones[map];
+	for (size_t i = 0; i < g_mapData.zone_count[map]; i++)
+	{
+		const ZoneRect zone = zones[i];
+		if (pos.x >= zone.x && pos.y >= zone.y && pos.x <= zone.x + zone.w && pos.y <= zone.y + zone.h)
+			hits++;
+	}
+
+	return hits;
+}
+
+static size_t zones_grid(int map, Vector2 pos)
+{
+	const uint16_t* cands;
+	size_t count = zone_grid_list(map, zone_grid_cell(map, pos.x, pos.y), &cands);
+
+	size_t hits = 0;
+	const ZoneRect* zones = g_mapData.zones[map];
+	for (size_t i = 0; i < count; i++)
+	{
+		const ZoneRect zone = zones[cands[i]];
+		if (pos.x >= zone.x && pos.y >= zone.y && pos.x <= zone.x + zone.w && pos.y <= zone.y + zone.h)
+			hits++;
+	}
+
+	return hits;
+}
+
+static double bench_ns(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / ((double)BENCH_POINTS * BENCH_ROUNDS);
+}
+
+int main(int argc, char** argv)
+{
+	if (!map_data_init(argc > 1 ? argv[1] : MAPDATA_FILE) || !zone_grid_init())
+		return 1;
+
+	Rng rng;
+	rng_seed(&rng, 0x5EED);
+
+	double total_linear = 0, total_grid = 0;
+	for (int map = 0; map < MAPDATA_MAPS; map++)
+	{
+		const ZoneGrid* grid = &g_zoneGrid[map];
+		if (!grid->start)
+			continue;
+
+		// Cover the zones and a margin around them
+		float w = (float)(grid->cols * ZONEGRID_CELL) + 512;
+		float h = (float)(grid->rows * ZONEGRID_CELL) + 512;
+		for (int i = 0; i < BENCH_POINTS; i++)
+		{
+			points[i].x = (float)grid->x - 256 + w * (rng_next(&rng) / 4294967296.0f);
+			points[i].y = (float)grid->y - 256 + h * (rng_next(&rng) / 4294967296.0f);
+		}
+
+		for (int i = 0; i < BENCH_POINTS; i++)
+		{
+			if (zones_grid(map, points[i]) != zones_linear_packed(map, points[i]))
+			{
+				fprintf(stderr, "map %d: grid and scan disagree at (%f, %f)\n", map, points[i].x, points[i].y);
+				return 1;
+			}
+		}
+
+		size_t sink = 0;
+		clock_t start = clock();
+		for (int r = 0; r < BENCH_ROUNDS; r++)
+			for (int i = 0; i < BENCH_POINTS; i++)
+				sink += zones_linear(map, points[i]);
+		double linear = bench_ns(start);
+
+		start = clock();
+		for (int r = 0; r < BENCH_ROUNDS; r++)
+			for (int i = 0; i < BENCH_POINTS; i++)
+				sink += zones_grid(map, points[i]);
+		double grid_ns = bench_ns(start);
+
+		total_linear += linear;
+		total_grid += grid_ns;
+		printf("map %2d: %3d zones, scan %7.2f ns, grid %6.2f ns (%.1fx) [%d]\n",
+			map, (int)g_mapZoneSize[map], linear, grid_ns, grid_ns > 0 ? linear / grid_ns : 0.0, (int)(sink & 1));
+	}
+
+	printf("all maps: scan %.2f ns, grid %.2f ns per check\n", total_linear / MAPDATA_MAPS, total_grid / MAPDATA_MAPS);
+	return 0;
+}
@@ -0,0 +1,41 @@
+#include <MapData.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+	Bakes the compiled zone and spawn tables into the blob
+	the server maps at startup (see MapData.h for the layout).
+*/
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: %s <output>\n", argv[0]);
+		return 1;
+	}
+
+	size_t size = map_data_pack(NULL, 0);
+	uint8_t* blob = (uint8_t*)malloc(size);
+	if (size == 0 || !blob || map_data_pack(blob, size) != size)
+	{
+		fprintf(stderr, "map data does not fit the blob format\n");
+		free(blob);
+		return 1;
+	}
+
+	FILE* file = fopen(argv[1], "wb");
+	if (!file || fwrite(blob, 1, size, file) != size)
+	{
+		fprintf(stderr, "failed to write %s\n", argv[1]);
+		if (file)
+			fclose(file);
+
+		free(blob);
+		return 1;
+	}
+
+	fclose(file);
+	free(blob);
+	printf("%s: %d bytes\n", argv[1], (int)size);
+	return 0;
+}
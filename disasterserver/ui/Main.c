@@ -479,11 +479,9 @@ void ui_update_playerlist(Server* server)
 bool ui_update_delete(Component* component)
 {
 	DeleteButton* delete = (DeleteButton*)component;
-	if (cJSON_HasObjectItem(delete->root, delete->key))
+	if (store_get(delete->store, delete->key))
 	{
-		cJSON_DeleteItemFromObject(delete->root, delete->key);
-
-		if (!collection_save(delete->collection, delete->root))
+		if (!store_remove(delete->store, delete->key))
 			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error (Report to dev)", "Failed to save collection!", NULL);
 	}
 	return false;
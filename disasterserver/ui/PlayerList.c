@@ -99,7 +99,7 @@ bool playerlist_bans_update(SDL_Renderer* renderer, struct _Component* component
     SDL_RenderCopy(renderer, g_textureSheet, &title_src, &title_dst);
 
     Label label = LabelCreate(list->x + 8, list->y + 8, "", INTERFACE_SCALE);
-    DeleteButton delete = (DeleteButton){ 4672, 40, 43, 8, button_update, list->x + 20 * 2, list->y - 2 + 8, 43, 8, ui_update_delete, false, BANS_FILE, g_bans, NULL };
+    DeleteButton delete = (DeleteButton){ 4672, 40, 43, 8, button_update, list->x + 20 * 2, list->y - 2 + 8, 43, 8, ui_update_delete, false, &g_banStore, NULL };
 
     MutexLock(g_banMut);
     {
@@ -186,7 +186,7 @@ bool playerlist_op_update(SDL_Renderer* renderer, struct _Component* component)
     SDL_RenderCopy(renderer, g_textureSheet, &title_src, &title_dst);
 
     Label label = LabelCreate(list->x + 8, list->y + 8, "", INTERFACE_SCALE);
-    DeleteButton delete = (DeleteButton){ 4672, 40, 43, 8, button_update, list->x + 20 * 2, list->y - 2 + 8, 43, 8, ui_update_delete, false, OPERATORS_FILE, g_ops, NULL };
+    DeleteButton delete = (DeleteButton){ 4672, 40, 43, 8, button_update, list->x + 20 * 2, list->y - 2 + 8, 43, 8, ui_update_delete, false, &g_opStore, NULL };
 
     MutexLock(g_opMut);
     {        
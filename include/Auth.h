@@ -14,6 +14,6 @@ typedef struct
 typedef struct PeerData PeerData;
 
 bool auth_create_ticket(PeerData* peer, Packet* packet);
-bool auth_verify_ticket(PeerData* peer, Packet* packet);
+bool auth_verify_ticket(PeerData* peer, PacketView* packet);
 
 #endif
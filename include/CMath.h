@@ -1,6 +1,8 @@
 #ifndef CMATH_H
 #define CMATH_H
 #include <math.h>
+#include <stdint.h>
+#include <stddef.h>
 
 typedef struct
 {
@@ -12,6 +14,10 @@ float	lerp(float a, float b, float f);
 float	sign(float x);
 
 float	vector2_dist(Vector2* a, Vector2* b);
+float	vector2_dist_sq(const Vector2* a, const Vector2* b);
+
+/* Bit i is set if (xs[i], ys[i]) is within radius of center, takes up to 64 points */
+uint64_t vector2_within(const Vector2* center, const float* xs, const float* ys, size_t count, float radius);
 Vector2	vector2_dir(Vector2* a, Vector2* b);
 
 #endif
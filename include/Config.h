@@ -3,6 +3,8 @@
 
 #include <cJSON.h>
 #include <Api.h>
+#include <Store.h>
+#include <IpTrie.h>
 #include <io/Threads.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -13,12 +15,20 @@
 	#define BANS_FILE "Bans.json"
 	#define OPERATORS_FILE "Operators.json"
 	#define TIMEOUTS_FILE "Timeouts.json"
+	#define BANS_JOURNAL "Bans.journal"
+	#define OPERATORS_JOURNAL "Operators.journal"
+	#define TIMEOUTS_JOURNAL "Timeouts.journal"
+	#define MAPDATA_FILE "MapData.bin"
 #else
 	#define ANDROID_DIR "/data/data/com.teamexeempire.disaster2d/files/"
 	#define CONFIG_FILE ANDROID_DIR "Config.json"
 	#define BANS_FILE ANDROID_DIR "Bans.json"
 	#define OPERATORS_FILE ANDROID_DIR "Operators.json"
 	#define TIMEOUTS_FILE ANDROID_DIR "Timeouts.json"
+	#define BANS_JOURNAL ANDROID_DIR "Bans.journal"
+	#define OPERATORS_JOURNAL ANDROID_DIR "Operators.journal"
+	#define TIMEOUTS_JOURNAL ANDROID_DIR "Timeouts.journal"
+	#define MAPDATA_FILE ANDROID_DIR "MapData.bin"
 #endif
 
 typedef struct
@@ -26,6 +36,8 @@ typedef struct
 	int32_t port;
 	int32_t	server_count;
 	int32_t ping_limit;
+	int32_t heartbeat_interval; /* ms without traffic before a heartbeat is sent */
+	uint32_t rng_seed;			/* 0 seeds lobbies randomly, otherwise every match replays the same rolls */
 	bool	log_debug;
 	bool	log_file;
 	bool	anticheat;
@@ -37,9 +49,12 @@ typedef struct
 } Config;
 
 SERVER_API extern Config g_config;
-SERVER_API extern cJSON* g_bans;
+SERVER_API extern cJSON* g_bans;		/* Mirrors of the stores below, read only */
 SERVER_API extern cJSON* g_timeouts;
 SERVER_API extern cJSON* g_ops;
+SERVER_API extern Store	g_banStore;
+SERVER_API extern Store	g_timeoutStore;
+SERVER_API extern Store	g_opStore;
 SERVER_API extern Mutex	g_banMut;
 SERVER_API extern Mutex	g_timeoutMut;
 SERVER_API extern Mutex	g_opMut;
@@ -48,8 +63,9 @@ SERVER_API bool	config_init(void);
 SERVER_API bool config_save(void);
 
 SERVER_API bool	ban_add(const char* nickname, const char* udid, const char* ip);
+SERVER_API bool	ban_add_range(const char* nickname, const char* range); /* "10.0.0.0/8", "::ffff:10.0.0.0/104" */
 SERVER_API bool	ban_revoke(const char* udid, const char* ip);
-SERVER_API bool	ban_check(const char* udid, const char* ip, bool* result);
+SERVER_API bool	ban_check(const char* udid, const IpAddr* addr, bool* result);
 
 SERVER_API bool	timeout_set(const char* nickname, const char* udid, const char* ip, uint64_t timestamp);
 SERVER_API bool	timeout_revoke(const char* udid, const char* ip);
@@ -59,6 +75,7 @@ SERVER_API bool	op_add(const char* nickname, const char* ip);
 SERVER_API bool	op_revoke(const char* ip);
 SERVER_API bool	op_check(const char* ip, bool* result);
 
+bool collection_init(cJSON** output, const char* file, const char* default_value);
 bool collection_save(const char* file, cJSON* value);
 
 #endif
\ No newline at end of file
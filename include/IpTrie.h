@@ -0,0 +1,49 @@
+#ifndef IPTRIE_H
+#define IPTRIE_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define IP_BITS		128
+#define IP_STRLEN	64	/* Longest ip_format output, "/128" included */
+
+/* Address in network order, IPv4 is kept IPv4-mapped (::ffff:a.b.c.d) */
+typedef struct
+{
+	uint8_t bytes[16];
+} IpAddr;
+
+/*
+	Binary radix trie of address prefixes, one level per bit, so a lookup
+	takes at most IP_BITS steps and never touches a string. Nodes live in
+	one array and refer to each other by index, 0 meaning no child.
+	Different spellings of one prefix ("10.0.0.7/8" and "10.0.0.0/8")
+	end on the same node, so a node counts how many times it was stored
+	and only stops matching once all of them are removed.
+*/
+typedef struct
+{
+	uint32_t	child[2];
+	uint32_t	refs;	/* Stored prefixes ending here, 0 if none */
+} IpTrieNode;
+
+typedef struct
+{
+	IpTrieNode*	nodes;
+	uint32_t	count;
+	uint32_t	capacity;
+	uint32_t	free_list;	/* Pruned nodes, chained through child[0] */
+	size_t		prefixes;
+} IpTrie;
+
+void	ip_addr_v4		(IpAddr* addr, uint32_t host);
+bool	ip_parse		(const char* str, IpAddr* addr, uint8_t* prefix);
+void	ip_format		(const IpAddr* addr, uint8_t prefix, char* out, size_t size);
+
+bool	ip_trie_init	(IpTrie* trie);
+bool	ip_trie_insert	(IpTrie* trie, const IpAddr* addr, uint8_t prefix);
+bool	ip_trie_remove	(IpTrie* trie, const IpAddr* addr, uint8_t prefix);
+bool	ip_trie_match	(const IpTrie* trie, const IpAddr* addr);
+void	ip_trie_free	(IpTrie* trie);
+
+#endif
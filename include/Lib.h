@@ -46,12 +46,14 @@ SERVER_API bool				disaster_server_lock			(struct Server* server);
 SERVER_API bool				disaster_server_unlock			(struct Server* server);
 SERVER_API uint8_t			disaster_server_state			(struct Server* server);
 SERVER_API bool				disaster_server_ban				(struct Server* server, uint16_t);
+SERVER_API bool				disaster_server_ban_range		(struct Server* server, uint16_t, uint8_t);
 SERVER_API bool				disaster_server_op				(struct Server* server, uint16_t);
 SERVER_API bool				disaster_server_timeout			(struct Server* server, uint16_t, double);
 SERVER_API bool				disaster_server_peer			(struct Server*, int, PeerInfo*);
 SERVER_API bool				disaster_server_peer_disconnect	(struct Server*, uint16_t, DisconnectReason, const char*);
 SERVER_API int				disaster_server_peer_count		(struct Server*);
 SERVER_API int				disaster_server_peer_ingame		(struct Server*);
+SERVER_API uint32_t			disaster_server_backlog			(struct Server*);
 SERVER_API int8_t			disaster_game_map				(struct Server*);
 SERVER_API double			disaster_game_time				(struct Server*);
 SERVER_API uint16_t			disaster_game_time_sec			(struct Server*);
@@ -0,0 +1,65 @@
+#ifndef MAPDATA_H
+#define MAPDATA_H
+#include <CMath.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define MAPDATA_MAGIC		0x444D5344 /* "DSMD" */
+#define MAPDATA_VERSION		3
+#define MAPDATA_MAPS		21
+#define MAPDATA_MAXSPAWNS	64
+#define MAPDATA_SUBPIXEL	8		/* Zone edges are kept in 1/8 px steps */
+#define MAPDATA_COORD_MAX	32767	/* Bound for every zone and spawn value */
+
+typedef enum
+{
+	SPAWN_TDOLL,		/* Tails Doll respawn spots */
+	SPAWN_RMZ_SLUG,		/* Ravine Mist slug spawners */
+	SPAWN_RMZ_SHARD,	/* Ravine Mist shard candidates */
+	SPAWN_COUNT
+} SpawnTable;
+
+typedef struct
+{
+	float x, y, w, h;	/* Multiples of 1/MAPDATA_SUBPIXEL, so edges add up exactly */
+} ZoneRect;
+
+typedef struct
+{
+	int16_t x, y;
+} SpawnPoint;
+
+/*
+	Blob layout (little-endian, produced by PackMaps):
+		header		magic32, version16, maps16, spawns16, reserved16, size32, hash64
+		ranges		(offset32, count32) per map, then per spawn table
+		data		ZoneRect (float32) and SpawnPoint (int16) arrays, offsets relative to the blob
+
+	hash is FNV-1a over everything after the header and catches truncated
+	or edited files. A blob that passes the checks replaces the tables
+	compiled into the server, that is how map data is swapped without a
+	rebuild; anything else falls back to the compiled tables.
+*/
+#define MAPDATA_HEADER	24
+#define MAPDATA_RANGE	8
+
+typedef struct
+{
+	const ZoneRect*		zones[MAPDATA_MAPS];
+	uint16_t			zone_count[MAPDATA_MAPS];
+	const SpawnPoint*	spawns[SPAWN_COUNT];
+	uint16_t			spawn_count[SPAWN_COUNT];
+} MapData;
+
+extern MapData			g_mapData;
+
+/* Compiled tables, the source PackMaps bakes and the fallback when no blob is found */
+extern const Vector2*	g_spawnTable[SPAWN_COUNT];
+extern size_t			g_spawnTableSize[SPAWN_COUNT];
+
+size_t		map_data_pack	(uint8_t* out, size_t cap);
+uint64_t	map_data_hash	(const uint8_t* blob, size_t size);
+bool		map_data_init	(const char* path);
+
+#endif
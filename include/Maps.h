@@ -10,7 +10,7 @@ typedef struct
 	{
 		bool (*init)(Server*);
 		bool (*tick)(Server*);
-		bool (*tcp_msg)(PeerData*, Packet*);
+		bool (*tcp_msg)(PeerData*, PacketView*);
 		bool (*left)(PeerData*);
 	} cb;
 
@@ -23,7 +23,7 @@ extern Map g_mapList[MAP_COUNT+1];
 
 bool map_init 	(Server* server);
 bool map_tick 	(Server* server);
-bool map_tcpmsg (PeerData* v, Packet* packet);
+bool map_tcpmsg (PeerData* v, PacketView* packet);
 bool map_left 	(PeerData* v);
 
 bool map_time (Server* server, double seconds, float mul);
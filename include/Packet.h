@@ -3,6 +3,7 @@
 #include <Log.h>
 #include <enet/enet.h>
 #include <stdint.h>
+#include <string.h>
 
 typedef enum
 {
@@ -163,18 +164,87 @@ typedef enum
 	SERVER_PREIDENTITY,
 	SERVER_FELLA,
 
-	CLIENT_PLAYER_POTATER
+	CLIENT_PLAYER_POTATER,
+
+	// Extended protocol (BUILD_VERSION_EXT clients only)
+	SERVER_BUNDLE,
+	SERVER_ROSTER_SNAPSHOT,
+	SERVER_ROSTER_DELTA
 } PacketType;
 
+/*
+	Roster messages for extended clients, replacing the per-peer
+	SERVER_WAITING_PLAYER_INFO, SERVER_PLAYER_LEFT and
+	SERVER_LOBBY_CHARACTER_CHANGE messages.
+
+	Entry:		[id 16][flags 8][lobby icon 8][character 8][nickname]
+	Snapshot:	[0][SERVER_ROSTER_SNAPSHOT][count 8] followed by entries
+	Delta:		[0][SERVER_ROSTER_DELTA][op 8][entry] (leave only carries the id)
+*/
+typedef enum
+{
+	ROSTER_JOIN,
+	ROSTER_LEAVE,
+	ROSTER_CHANGE
+} RosterOp;
+
+#define ROSTER_IN_GAME	(1 << 0)
+#define ROSTER_EXE		(1 << 1)
+
 typedef struct
 {
 	#define PACKET_MAXSIZE 256
-
+	#define PACKET_MAXGROWN 65535
 	uint8_t buff[PACKET_MAXSIZE];
-	uint8_t pos;
-	uint8_t len;
+
+	/* Worker arena memory once the packet outgrows buff */
+	uint8_t*	ext;
+	uint16_t	cap;
+
+	uint16_t	pos;
+	uint16_t	len;
 } Packet;
 
+/*
+	Per-thread bump allocator backing grown packets,
+	reset by the worker on every iteration.
+*/
+typedef struct
+{
+	#define PACKET_ARENA_SIZE (1 << 18)
+	uint8_t*	buff;
+	size_t		used;
+} PacketArena;
+
+#define packet_data(packet) ((packet)->ext ? (packet)->ext : (packet)->buff)
+
+/*
+	Read-only view straight over a received ENet buffer,
+	every read is checked against the full width it consumes.
+*/
+typedef struct
+{
+	const uint8_t*	data;
+	size_t			pos;
+	size_t			len;
+
+	/* Received ENet packet, kept alive for relaying */
+	ENetPacket*		source;
+} PacketView;
+
+/* 
+	Messages queued for one peer during a tick, sent as a single datagram.
+	Layout: [0][SERVER_BUNDLE] followed by [length 16][message] per message.
+*/
+typedef struct
+{
+	#define BUNDLE_MAXSIZE 1024
+
+	uint8_t		buff[BUNDLE_MAXSIZE];
+	uint16_t	len;
+	uint16_t	count;
+} PacketBundle;
+
 /* UTF-8 supporting string */
 typedef struct
 {
@@ -187,21 +257,100 @@ size_t string_length(String* str);
 String string_lower(String str);
 #define __Str(x) string_new(x)
 
-bool 	packet_new(Packet* packet, PacketType type);
-Packet 	packet_from(ENetPacket* packet);
+bool 		packet_new(Packet* packet, PacketType type);
+PacketView 	packet_view(ENetPacket* packet);
 
 struct Server;
+ENetPacket* packet_build(Packet* packet, bool reliable);
 bool packet_send(ENetPeer* peer, Packet* packet, bool reliable);
 bool packet_send_id(struct Server* server, uint16_t id, Packet* packet, bool reliable);
-bool packet_seek(Packet* packet, int wh);
+bool packet_seek(PacketView* packet, size_t wh);
 
-bool packet_read8(Packet* packet, uint8_t* out);
-bool packet_read16(Packet* packet, uint16_t* out);
-bool packet_read32(Packet* packet, uint32_t* out);
-bool packet_read64(Packet* packet, uint64_t* out);
-bool packet_readfloat(Packet* packet, float* out);
-bool packet_readdouble(Packet* packet, double* out);
-bool packet_readstr(Packet* packet, String* out);
+struct PeerData;
+bool packet_bundle_append(struct PeerData* peer, const uint8_t* data, size_t len, bool reliable);
+bool packet_bundle_flush(struct PeerData* peer);
+
+#ifdef __GNUC__ // GCC, clang...
+	#define BYTESWAP_16(x) __builtin_bswap16((x))
+	#define BYTESWAP_32(x) __builtin_bswap32((x))
+	#define BYTESWAP_64(x) __builtin_bswap64((x))
+#else
+	#define BYTESWAP_16(x) _byteswap_ushort((x))
+	#define BYTESWAP_32(x) _byteswap_ulong((x))
+	#define BYTESWAP_64(x) _byteswap_uint64((x))
+#endif
+
+static inline bool packet_read8(PacketView* packet, uint8_t* out)
+{
+	// Defined even when the read fails, the store folds into the one below
+	*out = 0;
+	RAssert(packet->len - packet->pos >= 1);
+	*out = packet->data[packet->pos++];
+
+	return true;
+}
+
+static inline bool packet_read16(PacketView* packet, uint16_t* out)
+{
+	*out = 0;
+	RAssert(packet->len - packet->pos >= 2);
+	memcpy(out, &packet->data[packet->pos], 2);
+
+#ifdef SYS_BIG_ENDIAN
+	*out = BYTESWAP_16(*out);
+#endif
+
+	packet->pos += 2;
+	return true;
+}
+
+static inline bool packet_read32(PacketView* packet, uint32_t* out)
+{
+	*out = 0;
+	RAssert(packet->len - packet->pos >= 4);
+	memcpy(out, &packet->data[packet->pos], 4);
+
+#ifdef SYS_BIG_ENDIAN
+	*out = BYTESWAP_32(*out);
+#endif
+
+	packet->pos += 4;
+	return true;
+}
+
+static inline bool packet_read64(PacketView* packet, uint64_t* out)
+{
+	*out = 0;
+	RAssert(packet->len - packet->pos >= 8);
+	memcpy(out, &packet->data[packet->pos], 8);
+
+#ifdef SYS_BIG_ENDIAN
+	*out = BYTESWAP_64(*out);
+#endif
+
+	packet->pos += 8;
+	return true;
+}
+
+static inline bool packet_readfloat(PacketView* packet, float* out)
+{
+	uint32_t raw = 0;
+	RAssert(packet_read32(packet, &raw));
+	memcpy(out, &raw, 4);
+
+	return true;
+}
+
+static inline bool packet_readdouble(PacketView* packet, double* out)
+{
+	uint64_t raw = 0;
+	RAssert(packet_read64(packet, &raw));
+	memcpy(out, &raw, 8);
+
+	return true;
+}
+
+bool packet_readstr(PacketView* packet, String* out);
 
 bool packet_write8(Packet* packet, uint8_t value);
 bool packet_write16(Packet* packet, uint16_t value);
@@ -210,6 +359,11 @@ bool packet_write64(Packet* packet, uint64_t value);
 bool packet_writefloat(Packet* packet, float value);
 bool packet_writedouble(Packet* packet, double value);
 bool packet_writestr(Packet* packet, String value);
+bool packet_writeblob(Packet* packet, const void* data, size_t len);
+
+bool packet_arena_init(PacketArena* arena);
+void packet_arena_reset(PacketArena* arena);
+void packet_arena_free(PacketArena* arena);
 
 #define PacketCreate(packet, type) RAssert(packet_new(packet, type))
 #define PacketRead(outname, packet, func, type)\
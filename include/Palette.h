@@ -4,6 +4,6 @@
 #include <Server.h>
 #include <stdbool.h>
 
-bool palette_player_validate(PeerData* v, Packet* packet);
+bool palette_player_validate(PeerData* v, PacketView* packet);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef PEERSET_H
+#define PEERSET_H
+#include <IpTrie.h>
+#include <io/Threads.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+	Addresses and UDIDs of everyone connected across all lobbies, used to
+	turn away a second connection from the same player. Keys are 64-bit
+	hashes spread over shards with their own spinlock, so lobbies only
+	contend when they hit the same shard. Fixed size and zero-initialized,
+	nothing to set up. Keys are counted, operators may join twice.
+*/
+#define PEERSET_SHARDS	16
+#define PEERSET_SLOTS	256		/* Per shard, power of two */
+
+typedef struct
+{
+	uint64_t	hash;	/* 0 for free slots */
+	uint32_t	count;
+} PeerSetSlot;
+
+typedef struct
+{
+	Spinlock	lock;
+	uint32_t	count;
+	PeerSetSlot	slots[PEERSET_SLOTS];
+} PeerSetShard;
+
+uint64_t	peer_set_key_ip		(const IpAddr* addr);
+uint64_t	peer_set_key_udid	(const char* udid);
+bool		peer_set_has		(uint64_t key);
+bool		peer_set_add		(uint64_t key);
+void		peer_set_remove		(uint64_t key);
+
+#endif
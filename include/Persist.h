@@ -0,0 +1,35 @@
+#ifndef PERSIST_H
+#define PERSIST_H
+#include <Store.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+	Store changes are handed to a dedicated thread through a lock-free
+	multi-producer queue, so lobby threads never wait on the disk. The
+	thread wakes every PERSIST_INTERVAL ms, appends whatever queued up
+	with one flush per journal, expires timed entries and runs due
+	compactions; the JSON file is snapshotted under the store's mutex
+	but written outside of it.
+*/
+#define PERSIST_INTERVAL	50		/* ms between queue drains */
+#define PERSIST_MAXSTORES	4
+#define PERSIST_EXPIRE_BATCH	256		/* Expired entries dropped per lock */
+
+typedef struct PersistRecord
+{
+	struct PersistRecord*	next;
+	Store*					store;
+	uint64_t				seq;	/* Store change number, older ones are already in the JSON file */
+	uint64_t				value;
+	char					op;		/* '+' or '-' */
+	char*					key;
+	char*					name;	/* NULL for removals */
+} PersistRecord;
+
+bool	persist_init	(Store** stores, size_t count);
+bool	persist_push	(Store* store, uint64_t seq, char op, const char* key, const char* name, uint64_t value);
+void	persist_stop	(void);
+
+#endif
@@ -53,6 +53,13 @@ typedef struct
 	Vector2		start_pos;
 	Vector2		pos;
 
+	/* Anticheat zones, refreshed when pos changes */
+	bool			zone_valid;	/* Fields below match pos */
+	uint8_t			zone_hits;	/* Zones containing pos */
+	int32_t			zone_cell;	/* Grid cell the candidates belong to */
+	const uint16_t*	zone_cands;
+	size_t			zone_ncands;
+
 	struct
 	{
 		double		survive_time;
@@ -79,5 +86,6 @@ struct Server;
 struct PeerData;
 bool player_add_error (struct Server* server, struct PeerData* v, uint16_t by);
 void player_check_zone(struct Server* server, struct PeerData* v);
+void player_update_zone(struct Server* server, struct PeerData* v, Vector2 pos);
 
 #endif
\ No newline at end of file
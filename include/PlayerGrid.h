@@ -0,0 +1,44 @@
+#ifndef PLAYERGRID_H
+#define PLAYERGRID_H
+#include <CMath.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+struct Server;
+struct PeerData;
+
+/*
+	Hashed uniform grid over in-game player positions, rebuilt at the
+	start of every game tick. Queries compare squared distances and
+	return players grouped by cell, not in peer order.
+*/
+#define PLAYERGRID_CELL		256.0f
+#define PLAYERGRID_BUCKETS	64
+#define PLAYERGRID_MAXQUERY	64		/* Result buffer size callers use, extra matches are dropped */
+
+typedef struct
+{
+	struct PeerData*	peer;
+	uint32_t			index;		/* Slot in server->peers, for callers that need peer order */
+	int32_t				cx, cy;
+} PlayerGridItem;
+
+typedef struct
+{
+	PlayerGridItem*	items;		/* Grouped by bucket */
+	float*			xs;			/* Positions when the grid was built, same order as items */
+	float*			ys;
+	uint16_t		start[PLAYERGRID_BUCKETS + 1];
+	size_t			count;
+	size_t			capacity;
+} PlayerGrid;
+
+bool	player_grid_build		(PlayerGrid* grid, struct Server* server);
+void	player_grid_remove		(PlayerGrid* grid, struct PeerData* peer);
+void	player_grid_free		(PlayerGrid* grid);
+size_t	player_grid_radius		(const PlayerGrid* grid, Vector2 center, float radius, struct PeerData** out, size_t max);
+size_t	player_grid_radius_ex	(const PlayerGrid* grid, Vector2 center, float radius, const PlayerGridItem** out, size_t max);
+size_t	player_grid_rect		(const PlayerGrid* grid, float x, float y, float w, float h, struct PeerData** out, size_t max);
+
+#endif
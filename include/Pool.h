@@ -0,0 +1,42 @@
+#ifndef POOL_H
+#define POOL_H
+#include <Log.h>
+#include <stdint.h>
+#include <entities/EntityTypes.h>
+
+/*
+	Per-match allocator: each class bumps its objects out of its own blocks
+	(so one entity type sits together in memory) and recycles them through
+	a free list, everything is dropped at once by pool_reset when the match ends.
+*/
+#define POOL_CLASS_LEFT	ET_COUNT			/* Left player records */
+#define POOL_CLASSES	(ET_COUNT + 1)		/* Entity types + left records */
+#define POOL_BLOCK_SIZE	(16 * 1024)
+
+typedef struct PoolBlock
+{
+	struct PoolBlock*	next;
+	size_t				used;
+	size_t				size;
+} PoolBlock;
+
+typedef struct
+{
+	PoolBlock*	blocks[POOL_CLASSES];
+	void*		free[POOL_CLASSES];
+	size_t		sizes[POOL_CLASSES];
+
+	/* Stats for the current match */
+	size_t		bytes;		/* Bytes handed out and not released */
+	size_t		peak_bytes;
+	size_t		reserved;	/* Bytes taken from the system for blocks */
+	uint32_t	live;		/* Objects handed out and not released */
+	uint32_t	allocs;
+	uint32_t	reused;		/* Allocations served from a free list */
+} Pool;
+
+void*	pool_alloc	(Pool* pool, uint8_t cls, size_t size);
+void	pool_release(Pool* pool, uint8_t cls, void* ptr);
+void	pool_reset	(Pool* pool);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef RNG_H
+#define RNG_H
+#include <stdint.h>
+
+/*
+	xoshiro128** generator, one per lobby so worker threads
+	never share state. Seeded through splitmix64.
+*/
+typedef struct
+{
+	uint32_t s[4];
+	uint64_t seed;	/* Seed the state was last built from */
+} Rng;
+
+void		rng_seed		(Rng* rng, uint64_t seed);
+uint64_t	rng_entropy		(uint64_t salt);
+
+static inline uint32_t rng_rotl(uint32_t x, int k)
+{
+	return (x << k) | (x >> (32 - k));
+}
+
+static inline uint32_t rng_next(Rng* rng)
+{
+	uint32_t* s = rng->s;
+	uint32_t result = rng_rotl(s[1] * 5, 7) * 9;
+	uint32_t t = s[1] << 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rng_rotl(s[3], 11);
+
+	return result;
+}
+
+/* Uniform in [0, n), 0 when n is 0 */
+static inline uint32_t rng_range(Rng* rng, uint32_t n)
+{
+	return (uint32_t)(((uint64_t)rng_next(rng) * n) >> 32);
+}
+
+#endif
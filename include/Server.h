@@ -3,12 +3,18 @@
 
 #include <Auth.h>
 #include <DyList.h>
+#include <SlotMap.h>
+#include <Pool.h>
+#include <Rng.h>
+#include <PlayerGrid.h>
+#include <IpTrie.h>
 #include <Lib.h>
 #include <Log.h>
 #include <Vote.h>
 #include <DyList.h>
 #include <Player.h>
 #include <Packet.h>
+#include <entities/EntityTypes.h>
 #include <io/Threads.h>
 #include <io/Time.h>
 #include <enet/enet.h>
@@ -18,6 +24,12 @@
 #define TICKSPERSEC 60
 #define BUILD_VERSION 1101
 
+// Clients identifying with this version opt into SERVER_BUNDLE framing
+#define BUILD_VERSION_EXT 1102
+
+// Max events handled per receive pass, rest waits for the next loop iteration
+#define RECV_BUDGET 256
+
 #define STR_HELPER(x) #x
 #define STRINGIFY(x) STR_HELPER(x)
 
@@ -27,6 +39,7 @@ typedef struct PeerData
 {
 	uint16_t id;
 	String ip;
+	IpAddr addr;
 	ENetPeer *peer;
 
 	/* General info */
@@ -37,6 +50,8 @@ typedef struct PeerData
 	int8_t pet;
 
 	bool verified;
+	bool ip_counted;	/* Address and UDID were added to the peer set, */
+	bool udid_counted;	/* only those are removed again on disconnect */
 	bool in_game;
 	bool op;
 	bool ready;
@@ -45,6 +60,10 @@ typedef struct PeerData
 	bool can_vote;
 	bool voted;
 	bool disconnecting;
+	bool ext_proto;
+
+	/* Outgoing messages for the current tick (ext_proto only), per channel */
+	PacketBundle bundle[2];
 
 	auth_peer_data auth;
 
@@ -76,6 +95,7 @@ typedef struct PeerData
 	/* State info */
 	uint8_t exe_chance;
 	double timeout;
+	double idle; /* Ticks since anything was last sent to this peer */
 	double vote_cooldown;
 
 	struct Server *server;
@@ -132,8 +152,19 @@ typedef struct
 	uint8_t bring_loc;
 
 	/* Entities */
-	uint16_t entid;
-	DyList entities;
+	SlotMap entities;
+	Pool pool;		/* Backs entities and left player records */
+
+	/* Live entities of each type, in spawn order */
+	struct Entity* type_head[ET_COUNT];
+	struct Entity* type_tail[ET_COUNT];
+	uint16_t type_count[ET_COUNT];
+
+	/* Entities to despawn after the tick, sized for every entity */
+	uint16_t* despawn;
+
+	/* In-game players by position, rebuilt every tick */
+	PlayerGrid players;
 
 	/* Rings */
 	bool rings[256];
@@ -160,10 +191,65 @@ typedef struct Results
 	double countdown;
 } Results;
 
+typedef struct
+{
+	/* Receive stage */
+	uint32_t backlog;		/* Events still queued after the last receive pass */
+	uint32_t backlog_peak;	/* Highest backlog since the lobby was created */
+	uint64_t deferred;		/* Events pushed to the next pass by RECV_BUDGET */
+
+	/* Broadcasts */
+	uint64_t allocs_saved;		/* Packet allocations avoided by sharing one ENetPacket */
+	uint32_t tick_allocs_saved;	/* Same, but for the last tick only */
+
+	/* Bundles */
+	uint64_t bundled;	/* Messages sent inside bundles */
+	uint64_t bundles;	/* Datagrams those messages were packed into */
+
+	/* Time from the start of a tick batch until its output was flushed */
+#define WIRE_HIST_BUCKETS 8
+	uint32_t wire_hist[WIRE_HIST_BUCKETS];
+
+	/* Heartbeats */
+	uint64_t heartbeats;			/* Sent because the peer was idle */
+	uint64_t heartbeats_avoided;	/* Skipped because other traffic was flowing */
+} NetStats;
+
+/* Static chat lines, encoded once per lobby */
+typedef enum
+{
+	MSG_LINE,
+	MSG_BANNER,
+	MSG_BANNER_INFO,
+	MSG_BUILD,
+	MSG_SERVER,
+	MSG_HELP_HINT,
+	MSG_HELP_HINT_INFO,
+	MSG_MOTD,
+
+	MSG_HELP_INFO,
+	MSG_HELP_LOBBY,
+	MSG_HELP_VK,
+	MSG_HELP_VP,
+	MSG_HELP_MAP,
+	MSG_HELP_KICK,
+	MSG_HELP_BAN,
+	MSG_HELP_OP,
+
+	MSG_COUNT
+} CachedMsg;
+
+typedef struct
+{
+	ENetPacket* packets[MSG_COUNT];	/* Each holds one reference of ours */
+	char motd[256];					/* Motd the MSG_MOTD packet was built from */
+} MsgCache;
+
 typedef struct Server
 {
 	uint16_t id;
 	bool running;
+	int32_t stopped;	/* Set once the worker thread returned, no more store records come from it */
 
 	enum
 	{
@@ -186,20 +272,42 @@ typedef struct Server
 	double delta;
 	DyList peers;
 	ENetHost *host;
+	NetStats net;
+	PacketArena arena;
+	MsgCache msgs;
+	Rng rng;			/* Only touched from the worker thread */
+	Rng auth_rng;		/* Anticheat tickets, always from entropy even with rng_seed set */
 } Server;
 
 bool server_state_joined(PeerData *v);
 bool server_state_left(PeerData *v);
-bool server_state_handle(PeerData *v, Packet *packet);
-bool server_msg_handle(Server *server, PacketType type, PeerData *v, Packet *packet);
+bool server_state_handle(PeerData *v, PacketView *packet);
+bool server_msg_handle(Server *server, PacketType type, PeerData *v, PacketView *packet);
 bool server_cmd_handle(Server *server, unsigned long hash, PeerData *v, String *msg);
 unsigned long server_cmd_parse(String *string);
 
 bool server_worker(Server *server);
+bool server_receive(Server *server);
+bool server_event(Server *server, ENetEvent *ev);
+size_t server_pending_events(Server *server);
 bool server_broadcast(Server *server, Packet *packet, bool reliable);
 bool server_broadcast_ex(Server *server, Packet *packet, bool reliable, uint16_t ignore);
+bool server_broadcast_raw(Server *server, ENetPacket *shared, bool reliable, uint16_t ignore);
+bool server_relay(Server *server, PacketView *packet, bool reliable, uint16_t ignore);
+bool server_relay_from(Server *server, PacketView *packet, bool reliable, uint16_t sender);
+bool server_broadcast_split(Server *server, Packet *legacy, Packet *ext, bool reliable, uint16_t ignore);
+bool server_roster_entry(Server *server, Packet *pack, PeerData *peer);
+bool server_roster_snapshot(Server *server, Packet *pack, uint16_t ignore);
+bool server_roster_delta(Server *server, PeerData *v, RosterOp op, Packet *legacy, uint16_t ignore);
 bool server_send_msg(Server *server, ENetPeer *peer, const char *message);
 bool server_broadcast_msg(Server *server, const char *message);
+bool server_msgcache_set(Server *server, CachedMsg msg, const char *message);
+bool server_msgcache_build(Server *server);
+void server_msgcache_free(Server *server);
+bool server_send_cached(Server *server, ENetPeer *peer, const CachedMsg *list, size_t count);
+bool server_flush_bundles(Server *server);
+void server_wire_latency(Server *server, double ms);
+void server_heartbeat(Server *server, Packet *pack);
 
 int server_total(Server *server);
 int server_ingame(Server *server);
@@ -0,0 +1,37 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+#include <Log.h>
+#include <stdint.h>
+
+/*
+	Dense container handing out 16 bit generational ids:
+	low 12 bits are the slot (+1, so ids are never 0), high 4 bits its generation.
+	Live items are kept packed in items[0..noitems) for iteration.
+*/
+typedef struct
+{
+	#define SLOTMAP_SLOT_BITS	12
+	#define SLOTMAP_SLOT_MASK	((1 << SLOTMAP_SLOT_BITS) - 1)
+	#define SLOTMAP_MAX			SLOTMAP_SLOT_MASK
+
+	void**		items;		/* Live items, packed */
+	uint16_t*	ids;		/* Id of each packed item */
+	uint16_t*	dense;		/* Slot -> index into items */
+	uint8_t*	gens;		/* Slot -> current generation */
+
+	/* Free slots, reused oldest first so ids don't repeat early */
+	uint16_t*	free;
+	size_t		free_head;
+	size_t		free_count;
+
+	size_t		noitems;
+	size_t		capacity;
+} SlotMap;
+
+bool		slotmap_create(SlotMap* map, size_t max_capacity);
+uint16_t	slotmap_insert(SlotMap* map, void* item);
+void*		slotmap_get(SlotMap* map, uint16_t id);
+void*		slotmap_remove(SlotMap* map, uint16_t id);
+void		slotmap_free(SlotMap* map);
+
+#endif
@@ -8,6 +8,9 @@
 #define AssertOrDisconnect(server, x) if(!(x)) { server_disconnect(server, v->peer, DR_OTHER, "AssertOrDisconnect(" #x ") failed!"); return false; }
 #define ENTITY_BODY \
 char tag[16];\
+EntityType etype;\
+struct Entity* type_prev;\
+struct Entity* type_next;\
 uint16_t id;\
 Vector2 pos;\
 bool (*init)(Server*, struct Entity*);\
@@ -19,7 +22,7 @@ typedef struct Entity
 {
 	ENTITY_BODY
 } Entity;
-#define MakeEntity(tag, x, y) tag, 0, (Vector2){ x, y },
+#define MakeEntity(type, x, y) { 0 }, type, NULL, NULL, 0, (Vector2){ x, y },
 
 #define CMD_HELP 45680751
 #define CMD_MAP 1478254
@@ -39,20 +42,20 @@ typedef struct Entity
 bool lobby_init				(Server* server);
 bool lobby_state_join		(PeerData* v);
 bool lobby_state_left		(PeerData* v);
-bool lobby_state_handle		(PeerData* v, Packet* packet);
+bool lobby_state_handle		(PeerData* v, PacketView* packet);
 bool lobby_state_tick		(Server* server);
 
 
 bool mapvote_init			(Server* server);
 bool mapvote_state_join		(PeerData * v);
 bool mapvote_state_left		(PeerData * v);
-bool mapvote_state_handle	(PeerData* v, Packet* packet);
+bool mapvote_state_handle	(PeerData* v, PacketView* packet);
 bool mapvote_state_tick		(Server* server);
 
 bool charselect_init			(int8_t map, Server* server);
 bool charselect_state_join		(PeerData* v);
 bool charselect_state_left		(PeerData* v);
-bool charselect_state_handle	(PeerData* v, Packet * packet);
+bool charselect_state_handle	(PeerData* v, PacketView * packet);
 bool charselect_state_tick		(Server* server);
 
 bool 	game_end				(Server* server, Ending ending, bool achiv);
@@ -60,16 +63,19 @@ bool	game_init				(int exe, int8_t map, Server* server);
 bool	game_uninit				(Server* server, bool show_results);
 bool	game_spawn				(Server* server, Entity* entity, size_t size, Entity** out);
 bool	game_despawn			(Server* server, Entity** out, uint16_t id);
+void	game_free				(Server* server, Entity* entity);
 int		game_find				(Server* server, Entity** out, char* tag, size_t count);
+int		game_find_type			(Server* server, Entity** out, EntityType type, size_t count);
+bool	game_entity_tick		(Server* server);
 
 bool	game_bigring			(Server* server, BigRingState state);
 bool	game_state_join			(PeerData* v);
 bool	game_state_left			(PeerData* v);
-bool	game_state_handletcp	(PeerData* v, Packet* packet);
+bool	game_state_handletcp	(PeerData* v, PacketView* packet);
 bool	game_state_tick			(Server* server);
 
 bool	results_init			(Server* server);
 bool	results_state_tick		(Server* server);
-bool	results_state_handle	(PeerData* v, Packet* packet);
+bool	results_state_handle	(PeerData* v, PacketView* packet);
 
 #endif
@@ -0,0 +1,82 @@
+#ifndef STORE_H
+#define STORE_H
+#include <cJSON.h>
+#include <io/Threads.h>
+#include <stdio.h>
+#include <time.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+	Keyed collection (bans, timeouts, operators) indexed by a hash table.
+	Changes are appended to a journal, the JSON file is only rewritten
+	when the journal gets compacted. root mirrors the contents as a cJSON
+	object ({ key: nickname } or { key: [nickname, value] } when timed)
+	for the UI and for export. Stores don't lock, callers hold *lock.
+
+	Timed stores also keep their entries in a min-heap on the timestamp.
+	store_expire drops what has run out without journaling it, an expired
+	timeout means nothing anyway and replaying its old record at startup
+	just expires it again.
+
+	Once persist_init has run, store_put and store_remove only queue the
+	journal record; the log_* fields, store_log, store_flush, store_save
+	and store_due then belong to the persistence thread.
+*/
+#define STORE_COMPACT_OPS	1024	/* Journal records before compaction is due */
+#define STORE_COMPACT_SECS	60		/* Age of the oldest uncompacted record before compaction is due */
+#define STORE_MAX_TIMED		65536	/* Timed entries kept, the soonest to expire makes room */
+#define STORE_RETRY_SECS	1		/* Wait after a failed save, doubles up to STORE_COMPACT_SECS */
+
+typedef struct
+{
+	uint64_t	hash;	/* 0 for free slots */
+	uint64_t	value;	/* Timestamp for timed stores */
+	cJSON*		item;	/* Mirror entry, NULL for removed slots; item->string is the key */
+	size_t		heap;	/* Position in the expiry heap (timed stores) */
+} StoreEntry;
+
+struct Store;
+typedef void (*StoreHook)(struct Store* store, const char* key, bool present);
+
+typedef struct Store
+{
+	const char*	file;
+	const char*	journal;
+	bool		timed;
+	Mutex*		lock;
+	StoreHook	hook;	/* Told about every store_put/store_remove that changed something */
+
+	cJSON*		root;
+	StoreEntry*	slots;
+	size_t		capacity;	/* Power of two */
+	size_t		count;
+	size_t		removed;	/* Tombstones */
+	uint64_t	seq;		/* Last change number handed out */
+
+	StoreEntry**	heap;	/* Timed entries, min-heap on value */
+	size_t			heap_count;
+	size_t			heap_capacity;
+
+	FILE*		log;
+	size_t		log_ops;	/* Records since the last compaction */
+	time_t		log_since;	/* When the first of them was written */
+	uint64_t	saved_seq;	/* Last change the JSON file holds */
+	time_t		save_retry;	/* After a failed save, not due again before this */
+	time_t		save_wait;	/* Current backoff in seconds, 0 after a good save */
+} Store;
+
+bool		store_init		(Store* store, const char* file, const char* journal, const char* default_value, bool timed, Mutex* lock);
+StoreEntry*	store_get		(Store* store, const char* key);
+bool		store_put		(Store* store, const char* key, const char* name, uint64_t value);
+bool		store_remove	(Store* store, const char* key);
+size_t		store_expire	(Store* store, uint64_t now, size_t max);
+
+bool		store_log		(Store* store, char op, const char* key, const char* name, uint64_t value);
+bool		store_flush		(Store* store);
+bool		store_due		(Store* store);
+char*		store_snapshot	(Store* store, uint64_t* seq);
+bool		store_save		(Store* store, const char* json, uint64_t seq);
+
+#endif
@@ -2,13 +2,34 @@
 #define ZONE_H
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 typedef struct
 {
 	double x, y, w, h;
 } Zone;
 
+/* Compiled tables, baked by PackMaps; the server reads g_mapData */
 extern Zone*	g_mapZone[21];
 extern size_t	g_mapZoneSize[21];
 
+/*
+	Uniform grid over a map's zones, built once at startup.
+	Each cell lists (in ascending order) the zones overlapping it.
+*/
+typedef struct
+{
+	#define ZONEGRID_CELL 128.0
+	double		x, y;		/* Top-left corner of the grid */
+	int32_t		cols, rows;
+	uint32_t*	start;		/* Cell -> first entry in zones, cols * rows + 1 entries */
+	uint16_t*	zones;
+} ZoneGrid;
+
+extern ZoneGrid	g_zoneGrid[21];
+
+bool	zone_grid_init	(void);
+int32_t	zone_grid_cell	(int map, double x, double y);
+size_t	zone_grid_list	(int map, int32_t cell, const uint16_t** out);
+
 #endif
\ No newline at end of file
@@ -12,6 +12,6 @@ typedef struct
 	uint8_t	 wid;
 	double	 start_time;
 } Act9Wall;
-#define MakeAct9Wall(wid, x, y) ((Act9Wall) { MakeEntity("act9wall", x, y) act9wall_init, act9wall_tick, NULL, wid, 0 })
+#define MakeAct9Wall(wid, x, y) ((Act9Wall) { MakeEntity(ET_ACT9WALL, x, y) act9wall_init, act9wall_tick, NULL, wid, 0 })
 
 #endif
\ No newline at end of file
@@ -12,6 +12,6 @@ typedef struct
 	uint8_t rid;
 	uint8_t red;
 } CreamRing;
-#define MakeCreamRing(x, y, red) ((CreamRing) { MakeEntity("cring", x, y) cring_init, NULL, cring_uninit, 255, red })
+#define MakeCreamRing(x, y, red) ((CreamRing) { MakeEntity(ET_CREAMRING, x, y) cring_init, NULL, cring_uninit, 255, red })
 
 #endif
\ No newline at end of file
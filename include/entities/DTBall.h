@@ -11,6 +11,6 @@ typedef struct
 	double	state;
 	uint8_t side;
 } DTBall;
-#define MakeDTBall() ((DTBall) { MakeEntity("dtball", 0, 0) NULL, dtball_tick, NULL, 0, 0 })
+#define MakeDTBall() ((DTBall) { MakeEntity(ET_DTBALL, 0, 0) NULL, dtball_tick, NULL, 0, 0 })
 
 #endif
\ No newline at end of file
@@ -16,7 +16,7 @@ typedef struct
 	double		timer;
 	float		vel;
 } DTStalactits;
-#define MakeDTStalactiti(id, x, y) ((DTStalactits) { MakeEntity("dttits", x, y) dtst_init, dtst_tick, NULL, id, 0, 1, x, y, 0, 0 })
+#define MakeDTStalactiti(id, x, y) ((DTStalactits) { MakeEntity(ET_DTSTALACTITS, x, y) dtst_init, dtst_tick, NULL, id, 0, 1, x, y, 0, 0 })
 
 bool dtst_activate(Server* server, DTStalactits* tits);
 
@@ -10,7 +10,7 @@ typedef struct
 
 	double vel;
 } Dummy;
-#define MakeDummy() ((Dummy) { MakeEntity("dummy", 1616, 2608) NULL, dummy_tick, NULL, 0 })
+#define MakeDummy() ((Dummy) { MakeEntity(ET_DUMMY, 1616, 2608) NULL, dummy_tick, NULL, 0 })
 
 void dummy_activate(Dummy* dummy, int8_t dir);
 
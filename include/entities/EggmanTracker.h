@@ -11,6 +11,6 @@ typedef struct
 
 	uint16_t activ_id;
 } EggTracker;
-#define MakeEggTrack(x, y) ((EggTracker) { MakeEntity("eggtrack", x, y) eggtrack_init, NULL, eggtrack_uninit, 0, })
+#define MakeEggTrack(x, y) ((EggTracker) { MakeEntity(ET_EGGTRACKER, x, y) eggtrack_init, NULL, eggtrack_uninit, 0, })
 
 #endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef ENTITYTYPES_H
+#define ENTITYTYPES_H
+
+/* Every entity type with its tag, MakeEntity takes the type */
+#define ENTITY_TYPES(X)\
+X(ET_RING,			"ring")\
+X(ET_CREAMRING,		"cring")\
+X(ET_BLACKRING,		"bring")\
+X(ET_TPROJECTILE,	"tproj")\
+X(ET_EGGTRACKER,	"eggtrack")\
+X(ET_EXELLERCLONE,	"exclone")\
+X(ET_SLUG,			"slug")\
+X(ET_SLUGSPAWNER,	"slugspawn")\
+X(ET_SHARD,			"shard")\
+X(ET_DTSTALACTITS,	"dttits")\
+X(ET_DTBALL,		"dtball")\
+X(ET_TAILSDOLL,		"tdoll")\
+X(ET_ACID,			"acid")\
+X(ET_THUNDER,		"thunder")\
+X(ET_YCRCONTROLLER,	"ycrctrl")\
+X(ET_PFLIFT,		"pflift")\
+X(ET_VASE,			"vase")\
+X(ET_LAVA,			"lava")\
+X(ET_SNOWBALL,		"snowball")\
+X(ET_ICE,			"ice")\
+X(ET_KAFBOX,		"kafbox")\
+X(ET_DUMMY,			"dummy")\
+X(ET_MJJUDGER,		"mjud")\
+X(ET_MJASS,			"mass")\
+X(ET_MJLAVA,		"mlava")\
+X(ET_LATERN,		"latrn")\
+X(ET_NPCONTROLLER,	"npctrl")\
+X(ET_SPIKECONTROLLER,"spikectrl")\
+X(ET_ACT9WALL,		"act9wall")\
+X(ET_LCCHAIN,		"lcchain")\
+X(ET_LCEYE,			"lceye")\
+X(ET_HDDOOR,		"hddoor")
+
+typedef enum
+{
+#define X(type, tag) type,
+	ENTITY_TYPES(X)
+#undef X
+	ET_COUNT
+} EntityType;
+
+extern const char* g_entityTags[ET_COUNT];
+
+#endif
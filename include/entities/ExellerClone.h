@@ -12,6 +12,6 @@ typedef struct
 	int8_t   dir;
 	uint16_t owner;
 } ExellerClone;
-#define MakeExellerClone(x, y, dir, owner) ((ExellerClone) { MakeEntity("exclone", x, y) exclone_init, NULL, exclone_uninit, dir, owner })
+#define MakeExellerClone(x, y, dir, owner) ((ExellerClone) { MakeEntity(ET_EXELLERCLONE, x, y) exclone_init, NULL, exclone_uninit, dir, owner })
 
 #endif
\ No newline at end of file
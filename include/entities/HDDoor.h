@@ -12,7 +12,7 @@ typedef struct
 	double		timer;
 } HDDoor;
 
-#define MakeHDDoor() ((HDDoor) { MakeEntity("hddoor", 0, 0) NULL, hddoor_tick, NULL, 0, 0 })
+#define MakeHDDoor() ((HDDoor) { MakeEntity(ET_HDDOOR, 0, 0) NULL, hddoor_tick, NULL, 0, 0 })
 bool	hddoor_toggle(Server* server, HDDoor* door);
 
 #endif
\ No newline at end of file
@@ -11,6 +11,6 @@ typedef struct
 	double	timer;
 	bool	flag;
 } Thunder;
-#define MakeThunder() ((Thunder) { MakeEntity("thunder", 0, 0) NULL, thunder_tick, NULL, (15 + (rand() % 5)) * TICKSPERSEC, 0 })
+#define MakeThunder(server) ((Thunder) { MakeEntity(ET_THUNDER, 0, 0) NULL, thunder_tick, NULL, (15 + rng_range(&(server)->rng, 5)) * TICKSPERSEC, 0 })
 
 #endif
\ No newline at end of file
@@ -13,7 +13,7 @@ typedef struct
 	double	 timer;
 	bool	 activated;
 } KafBox;
-#define MakeKafBox(nid) ((KafBox) { MakeEntity("kafbox", 0, 0) kafbox_init, kafbox_tick, NULL, nid, 0, 0, })
+#define MakeKafBox(nid) ((KafBox) { MakeEntity(ET_KAFBOX, 0, 0) kafbox_init, kafbox_tick, NULL, nid, 0, 0, })
 
 bool kafbox_activate(Server* server, KafBox* box, uint16_t pid, uint8_t is_proj);
 
@@ -17,6 +17,6 @@ typedef struct
 	}		state;
 } LCChain;
 
-#define MakeLCChain() ((LCChain) { MakeEntity("lcchain", 0, 0) NULL, lcchain_tick, NULL, 0, LCC_NONE })
+#define MakeLCChain() ((LCChain) { MakeEntity(ET_LCCHAIN, 0, 0) NULL, lcchain_tick, NULL, 0, LCC_NONE })
 
 #endif
\ No newline at end of file
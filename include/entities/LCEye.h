@@ -19,7 +19,7 @@ typedef struct
 
 } LCEye;
 
-#define MakeLCEye(id) ((LCEye) { MakeEntity("lceye", 0, 0) NULL, lceye_tick, NULL, id, 0, 0, 100, 0, 0, 0 })
+#define MakeLCEye(id) ((LCEye) { MakeEntity(ET_LCEYE, 0, 0) NULL, lceye_tick, NULL, id, 0, 0, 100, 0, 0, 0 })
 bool  lceye_update(Server* server, LCEye* eye);
 
 #endif
\ No newline at end of file
@@ -12,5 +12,5 @@ typedef struct
 	double timer;
 	bool state;
 } MAss;
-#define MakeMAss() ((MAss) { MakeEntity("mass", 0, 0) NULL, mass_tick, NULL, 10 * TICKSPERSEC, 0.0, false })
+#define MakeMAss() ((MAss) { MakeEntity(ET_MJASS, 0, 0) NULL, mass_tick, NULL, 10 * TICKSPERSEC, 0.0, false })
 #endif
\ No newline at end of file
@@ -17,5 +17,5 @@ typedef struct
 		MJJ_FIRE
 	} state;
 } MJew;
-#define MakeMJew() ((MJew) { MakeEntity("mjud", 0, 0) NULL, mjew_tick, NULL, (10 + rand() % 5) * TICKSPERSEC, 0.0, MJJ_WAIT })
+#define MakeMJew(server) ((MJew) { MakeEntity(ET_MJJUDGER, 0, 0) NULL, mjew_tick, NULL, (10 + rng_range(&(server)->rng, 5)) * TICKSPERSEC, 0.0, MJJ_WAIT })
 #endif
\ No newline at end of file
@@ -22,6 +22,6 @@ typedef struct
 	float		vel;
 
 } MLava;
-#define MakeMLava(start, dist) ((MLava) { MakeEntity("mlava", 0, start) NULL, mlava_tick, NULL, MLV_IDLE, 5 * TICKSPERSEC, start, dist, 0 })
+#define MakeMLava(start, dist) ((MLava) { MakeEntity(ET_MJLAVA, 0, start) NULL, mlava_tick, NULL, MLV_IDLE, 5 * TICKSPERSEC, start, dist, 0 })
 
 #endif
\ No newline at end of file
@@ -13,7 +13,7 @@ typedef struct
 	double		timer;
 
 } Ice;
-#define MakeIce(id) ((Ice) { MakeEntity("ice", 0, 0) NULL, ice_tick, NULL, id, 0, 0 })
+#define MakeIce(id) ((Ice) { MakeEntity(ET_ICE, 0, 0) NULL, ice_tick, NULL, id, 0, 0 })
 
 bool ice_activate(Server* server, Ice* ice);
 
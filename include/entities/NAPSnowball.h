@@ -24,7 +24,7 @@ typedef struct
 	float		p_anim[20];
 
 } Snowball;
-#define MakeSnowball(id, p_count, dir) ((Snowball) { MakeEntity("snowball", 0, 0) snowball_init, snowball_tick, NULL, id, 0, 0, 0, dir, 0, 0, 0, p_count, 0 })
+#define MakeSnowball(id, p_count, dir) ((Snowball) { MakeEntity(ET_SNOWBALL, 0, 0) snowball_init, snowball_tick, NULL, id, 0, 0, 0, dir, 0, 0, 0, p_count, 0 })
 
 bool snowball_activate(Server* server, Snowball* sb);
 
@@ -17,6 +17,6 @@ typedef struct
 	double	timer;
 	bool	balls;
 } NPController;
-#define MakeNPCtrl() ((NPController) { MakeEntity("npctrl", 0, 0) NULL, npctrl_tick, NULL, NPC_NONE, 0, 0, 0 })
+#define MakeNPCtrl() ((NPController) { MakeEntity(ET_NPCONTROLLER, 0, 0) NULL, npctrl_tick, NULL, NPC_NONE, 0, 0, 0 })
 
 #endif
\ No newline at end of file
@@ -15,7 +15,7 @@ typedef struct
 	bool		activated;
 
 } PFLift;
-#define MakePFLift(id, start, end) ((PFLift) { MakeEntity("pflift", 0, 0) pflift_init, pflift_tick, NULL, id, 0, start, end, 0, 0, 0 })
+#define MakePFLift(id, start, end) ((PFLift) { MakeEntity(ET_PFLIFT, 0, 0) pflift_init, pflift_tick, NULL, id, 0, start, end, 0, 0, 0 })
 
 bool pflift_init(Server* server, Entity* entity);
 bool pflift_tick(Server* server, Entity* entity);
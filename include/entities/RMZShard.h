@@ -10,6 +10,6 @@ typedef struct
 
 	uint8_t spawned;
 } Shard;
-#define MakeShard(x, y, spawned) ((Shard) { MakeEntity("shard", x, y) shard_init, NULL, NULL, spawned })
+#define MakeShard(x, y, spawned) ((Shard) { MakeEntity(ET_SHARD, x, y) shard_init, NULL, NULL, spawned })
 
 #endif
\ No newline at end of file
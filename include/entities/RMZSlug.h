@@ -28,7 +28,7 @@ typedef struct
 		SLUG_REDRING
 	} ring;
 } Slug;
-#define MakeSlug(x, y) ((Slug) { MakeEntity("slug", x, y) slug_init, slug_tick, slug_uninit, 0.f, 0.f, 0, 0 })
+#define MakeSlug(x, y) ((Slug) { MakeEntity(ET_SLUG, x, y) slug_init, slug_tick, slug_uninit, 0.f, 0.f, 0, 0 })
 
 bool slugspawn_tick(Server* server, Entity* entity);
 
@@ -40,6 +40,6 @@ typedef struct
 	double	 timer;
 	uint16_t slug;
 } SlugSpawner;
-#define MakeSlugSpawn(x, y) ((SlugSpawner) { MakeEntity("slugspawn", x, y) NULL, slugspawn_tick, NULL, (rand() % 10) * TICKSPERSEC, 0, 0 })
+#define MakeSlugSpawn(server, x, y) ((SlugSpawner) { MakeEntity(ET_SLUGSPAWNER, x, y) NULL, slugspawn_tick, NULL, rng_range(&(server)->rng, 10) * TICKSPERSEC, 0, 0 })
 
 #endif
\ No newline at end of file
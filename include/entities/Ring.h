@@ -12,6 +12,6 @@ typedef struct
 	uint8_t rid;
 	uint8_t red;
 } Ring;
-#define MakeRing() ((Ring) { MakeEntity("ring", 0, 0) ring_init, NULL, ring_uninit, 0, 0 })
+#define MakeRing() ((Ring) { MakeEntity(ET_RING, 0, 0) ring_init, NULL, ring_uninit, 0, 0 })
 
 #endif
\ No newline at end of file
@@ -11,6 +11,6 @@ typedef struct
 	uint8_t frame;
 	double timer;
 } SpikeController;
-#define MakeSpike() ((SpikeController) { MakeEntity("spikectrl", 0, 0) NULL, spike_tick, NULL, 0, 2 * TICKSPERSEC })
+#define MakeSpike() ((SpikeController) { MakeEntity(ET_SPIKECONTROLLER, 0, 0) NULL, spike_tick, NULL, 0, 2 * TICKSPERSEC })
 
 #endif
\ No newline at end of file
@@ -12,6 +12,6 @@ typedef struct
 	uint8_t		activated;
 	double		timer;
 } Acid;
-#define MakeAcid() ((Acid) { MakeEntity("acid", 0, 0) NULL, acid_tick, NULL, 0, 0, 0.0 })
+#define MakeAcid() ((Acid) { MakeEntity(ET_ACID, 0, 0) NULL, acid_tick, NULL, 0, 0, 0.0 })
 
 #endif
\ No newline at end of file
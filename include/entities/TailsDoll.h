@@ -20,6 +20,6 @@ typedef struct
 	double		timer;
 	double		velx, vely;
 } TailsDoll;
-#define MakeTailsDoll() ((TailsDoll) { MakeEntity("tdoll", 0, 0) tdoll_init, tdoll_tick, NULL, TDST_NONE, -1, 0, 0.0, 0.0 })
+#define MakeTailsDoll() ((TailsDoll) { MakeEntity(ET_TAILSDOLL, 0, 0) tdoll_init, tdoll_tick, NULL, TDST_NONE, -1, 0, 0.0, 0.0 })
 
 #endif
\ No newline at end of file
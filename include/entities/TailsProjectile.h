@@ -18,6 +18,6 @@ typedef struct
 
 	double	 timer;
 } TProjectile;
-#define MakeTailsProj(x, y, owner, dir, exe, charge, damage) ((TProjectile) { MakeEntity("tproj", x, y) tproj_init, tproj_tick, tproj_uninit, owner, dir, exe, charge, damage, 5 * TICKSPERSEC })
+#define MakeTailsProj(x, y, owner, dir, exe, charge, damage) ((TProjectile) { MakeEntity(ET_TPROJECTILE, x, y) tproj_init, tproj_tick, tproj_uninit, owner, dir, exe, charge, damage, 5 * TICKSPERSEC })
 
 #endif
\ No newline at end of file
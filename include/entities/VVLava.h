@@ -23,6 +23,6 @@ typedef struct
 	float		vel;
 
 } Lava;
-#define MakeLava(id, start, dist) ((Lava) { MakeEntity("lava", 0, start) NULL, lava_tick, NULL, id, LV_IDLE, (20 + rand() % 5) * TICKSPERSEC, start, dist, 0 })
+#define MakeLava(server, id, start, dist) ((Lava) { MakeEntity(ET_LAVA, 0, start) NULL, lava_tick, NULL, id, LV_IDLE, (20 + rng_range(&(server)->rng, 5)) * TICKSPERSEC, start, dist, 0 })
 
 #endif
\ No newline at end of file
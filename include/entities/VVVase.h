@@ -9,6 +9,6 @@ typedef struct
 	uint8_t vid;
 	uint8_t type;
 } Vase;
-#define MakeVase(id) ((Vase) { MakeEntity("vase", 0, 0) NULL, NULL, NULL, id, (rand() % 4) })
+#define MakeVase(server, id) ((Vase) { MakeEntity(ET_VASE, 0, 0) NULL, NULL, NULL, id, rng_range(&(server)->rng, 4) })
 
 #endif
\ No newline at end of file
@@ -14,6 +14,6 @@ typedef struct
 	uint8_t	lid;
 	uint16_t time;
 } Latern;
-#define MakeLatern() ((Latern) { MakeEntity("latrn", 0, 0) NULL, latern_tick, NULL, false, 0.0, 0, (7 + rand() % 2) })
+#define MakeLatern(server) ((Latern) { MakeEntity(ET_LATERN, 0, 0) NULL, latern_tick, NULL, false, 0.0, 0, (7 + rng_range(&(server)->rng, 2)) })
 
 #endif
\ No newline at end of file
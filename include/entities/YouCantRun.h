@@ -17,6 +17,6 @@ typedef struct
 	uint8_t		smoke_id;
 	uint8_t		activated;
 } YCRController;
-#define MakeYCRCtrl() ((YCRController) { MakeEntity("ycrctrl", 0, 0) NULL, ycrctrl_tick, NULL, YCC_NONE, 0, 0, 0 })
+#define MakeYCRCtrl() ((YCRController) { MakeEntity(ET_YCRCONTROLLER, 0, 0) NULL, ycrctrl_tick, NULL, YCC_NONE, 0, 0, 0 })
 
 #endif
\ No newline at end of file
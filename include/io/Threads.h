@@ -27,6 +27,16 @@
 	#define MutexCreate(mut) RAssert(pthread_mutex_init(&mut, NULL) == 0)
 	#define MutexLock(mut) RAssert(pthread_mutex_lock(&mut) == 0)
 	#define MutexUnlock(mut) RAssert(pthread_mutex_unlock(&mut) == 0)
+
+	#define AtomicExchangePtr(ptr, val) __atomic_exchange_n(ptr, val, __ATOMIC_ACQ_REL)
+	#define AtomicLoadPtr(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+	#define AtomicStorePtr(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+	#define AtomicLoad32(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+	#define AtomicStore32(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+
+	typedef int Spinlock;
+	#define SpinLock(lock) while (__atomic_exchange_n(&lock, 1, __ATOMIC_ACQUIRE)) { while (__atomic_load_n(&lock, __ATOMIC_RELAXED)) sched_yield(); }
+	#define SpinUnlock(lock) __atomic_store_n(&lock, 0, __ATOMIC_RELEASE)
 #else
 	#define WIN32_LEAN_AND_MEAN
 	#include <Windows.h>
@@ -47,8 +57,19 @@
 	#define MutexCreate(mut) (mut = CreateMutex(NULL, FALSE, NULL))
 	#define MutexLock(mut) RAssert(WaitForSingleObject(mut, INFINITE) == WAIT_OBJECT_0)
 	#define MutexUnlock(mut) RAssert(ReleaseMutex(mut))
+
+	#define AtomicExchangePtr(ptr, val) InterlockedExchangePointer((PVOID volatile*)(ptr), (val))
+	#define AtomicLoadPtr(ptr) InterlockedCompareExchangePointer((PVOID volatile*)(ptr), NULL, NULL)
+	#define AtomicStorePtr(ptr, val) InterlockedExchangePointer((PVOID volatile*)(ptr), (val))
+	#define AtomicLoad32(ptr) InterlockedCompareExchange((LONG volatile*)(ptr), 0, 0)
+	#define AtomicStore32(ptr, val) InterlockedExchange((LONG volatile*)(ptr), (val))
+
+	typedef LONG Spinlock;
+	#define SpinLock(lock) while (InterlockedExchange(&lock, 1)) { while (*(volatile LONG*)&lock) YieldProcessor(); }
+	#define SpinUnlock(lock) InterlockedExchange(&lock, 0)
 #endif
 
 extern ThreadVar g_threadName;
+extern ThreadVar g_packetArena;
 
 #endif
@@ -3,6 +3,6 @@
 #include "../Maps.h"
 
 bool dt_init(Server* server);
-bool dt_tcpmsg(PeerData* v, Packet* packet);
+bool dt_tcpmsg(PeerData* v, PacketView* packet);
 
 #endif
\ No newline at end of file
@@ -3,6 +3,6 @@
 #include "../Maps.h"
 
 bool ft_init(Server* server);
-bool ft_tcpmsg(PeerData* v, Packet* packet);
+bool ft_tcpmsg(PeerData* v, PacketView* packet);
 
 #endif
\ No newline at end of file
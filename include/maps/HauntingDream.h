@@ -3,6 +3,6 @@
 #include "../Maps.h"
 
 bool hd_init(Server* server);
-bool hd_tcpmsg(PeerData* v, Packet* packet);
+bool hd_tcpmsg(PeerData* v, PacketView* packet);
 
 #endif
\ No newline at end of file
@@ -3,6 +3,6 @@
 #include "../Maps.h"
 
 bool kaf_init		(Server* server);
-bool kaf_tcpmsg	(PeerData* v, Packet* packet);
+bool kaf_tcpmsg	(PeerData* v, PacketView* packet);
 
 #endif
\ No newline at end of file
@@ -3,6 +3,6 @@
 #include "../Maps.h"
 
 bool lc_init(Server* server);
-bool lc_tcpmsg(PeerData* v, Packet* packet);
+bool lc_tcpmsg(PeerData* v, PacketView* packet);
 
 #endif
\ No newline at end of file
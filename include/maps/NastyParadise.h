@@ -3,6 +3,6 @@
 #include "../Maps.h"
 
 bool nap_init(Server* server);
-bool nap_tcpmsg(PeerData* v, Packet* packet);
+bool nap_tcpmsg(PeerData* v, PacketView* packet);
 
 #endif
\ No newline at end of file
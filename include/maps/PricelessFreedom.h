@@ -3,6 +3,6 @@
 #include "../Maps.h"
 
 bool pf_init(Server* server);
-bool pf_tcpmsg(PeerData* v, Packet* packet);
+bool pf_tcpmsg(PeerData* v, PacketView* packet);
 
 #endif
\ No newline at end of file
@@ -4,7 +4,7 @@
 
 bool rmz_init(Server* server);
 bool rmz_tick(Server* server);
-bool rmz_tcpmsg(PeerData* v, Packet* packet);
+bool rmz_tcpmsg(PeerData* v, PacketView* packet);
 bool rmz_left(PeerData* v);
 
 #endif
\ No newline at end of file
@@ -3,6 +3,6 @@
 #include "../Maps.h"
 
 bool vv_init(Server* server);
-bool vv_tcpmsg(PeerData* v, Packet* packet);
+bool vv_tcpmsg(PeerData* v, PacketView* packet);
 
 #endif
\ No newline at end of file
@@ -120,8 +120,7 @@ typedef struct
 	ButtonCallback cb;
 	bool clicked;
 
-	const char* collection;
-	cJSON* root;
+	struct Store* store;	/* Caller holds the store's mutex */
 	const char* key;
 } DeleteButton;
 